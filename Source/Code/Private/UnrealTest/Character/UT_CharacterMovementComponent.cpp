@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Character/UT_CharacterMovementComponent.h"
+
+#include "GameFramework/Character.h"
+
+bool FUT_CharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	NetworkMoveType = MoveType;
+
+	bool bLocalSuccess = true;
+	const bool bIsSaving = Ar.IsSaving();
+
+	Ar << TimeStamp;
+
+	// Whole units are enough for an input scaled by MaxAcceleration, see RoundAcceleration
+	FVector_NetQuantize QuantizedAcceleration(Acceleration);
+	QuantizedAcceleration.NetSerialize(Ar, PackageMap, bLocalSuccess);
+
+	// Tenth of a unit, well under the allowed position error
+	FVector_NetQuantize10 QuantizedLocation(Location);
+	QuantizedLocation.NetSerialize(Ar, PackageMap, bLocalSuccess);
+
+	ControlRotation.SerializeCompressedShort(Ar);
+	SerializeOptionalValue<uint8>(bIsSaving, Ar, CompressedMoveFlags, 0);
+
+	if (!bIsSaving)
+	{
+		Acceleration = QuantizedAcceleration;
+		Location = QuantizedLocation;
+	}
+
+	// Only the final move is checked against the server position
+	if (MoveType == ENetworkMoveType::NewMove)
+	{
+		SerializeOptionalValue<UPrimitiveComponent*>(bIsSaving, Ar, MovementBase, nullptr);
+		SerializeOptionalValue<FName>(bIsSaving, Ar, MovementBaseBoneName, NAME_None);
+		SerializeOptionalValue<uint8>(bIsSaving, Ar, MovementMode, MOVE_Walking);
+	}
+
+	return !Ar.IsError() && bLocalSuccess;
+}
+
+FUT_CharacterNetworkMoveDataContainer::FUT_CharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+UUT_CharacterMovementComponent::UUT_CharacterMovementComponent()
+{
+	SetNetworkMoveDataContainer(MoveDataContainer);
+
+	DefaultSmoothLocationTime = NetworkSimulatedSmoothLocationTime;
+	DefaultSmoothRotationTime = NetworkSimulatedSmoothRotationTime;
+	LastUpdateTime = -1.f;
+	AverageUpdateInterval = 0.f;
+}
+
+FVector UUT_CharacterMovementComponent::RoundAcceleration(FVector InAccel) const
+{
+	// Clients simulate the acceleration the server gets from FVector_NetQuantize
+	return FVector(FMath::RoundToFloat(InAccel.X), FMath::RoundToFloat(InAccel.Y), FMath::RoundToFloat(InAccel.Z));
+}
+
+void UUT_CharacterMovementComponent::SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation)
+{
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		const float Now = GetWorld()->GetTimeSeconds();
+		if (LastUpdateTime < 0.f)
+		{
+			// Blueprint values are final by the first update
+			DefaultSmoothLocationTime = NetworkSimulatedSmoothLocationTime;
+			DefaultSmoothRotationTime = NetworkSimulatedSmoothRotationTime;
+		}
+		else
+		{
+			// Gaps after becoming relevant again are not part of the rate
+			const float UpdateInterval = FMath::Min(Now - LastUpdateTime, MAX_SMOOTH_LOCATION_TIME);
+			AverageUpdateInterval = FMath::Lerp(AverageUpdateInterval, UpdateInterval, UPDATE_INTERVAL_BLEND);
+		}
+		LastUpdateTime = Now;
+
+		// Smooth over the whole gap when the replication graph lowered the rate
+		if (DefaultSmoothLocationTime > 0.f)
+		{
+			const float SmoothScale = FMath::Clamp(AverageUpdateInterval, DefaultSmoothLocationTime, MAX_SMOOTH_LOCATION_TIME) / DefaultSmoothLocationTime;
+			NetworkSimulatedSmoothLocationTime = DefaultSmoothLocationTime * SmoothScale;
+			NetworkSimulatedSmoothRotationTime = DefaultSmoothRotationTime * SmoothScale;
+		}
+	}
+
+	Super::SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+}
+
+float UUT_CharacterMovementComponent::GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const
+{
+	const float NetMoveDelta = Super::GetClientNetSendDeltaTime(PC, ClientData, NewMove);
+	if (!ClientData || !NewMove.IsValid())
+	{
+		return NetMoveDelta;
+	}
+
+	// Holding a move identical to the previous one lets the next ones combine into it
+	for (int32 i = ClientData->SavedMoves.Num() - 1; i >= 0; i--)
+	{
+		const FSavedMovePtr& SavedMove = ClientData->SavedMoves[i];
+		if (SavedMove != NewMove)
+		{
+			if (SavedMove->CanCombineWith(NewMove, CharacterOwner, ClientData->MaxMoveDeltaTime))
+			{
+				return FMath::Max(NetMoveDelta, COMBINED_MOVE_DELTA_TIME);
+			}
+			break;
+		}
+	}
+
+	return NetMoveDelta;
+}
@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Character/UT_LagCompensationSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Net/UT_NetTime.h"
+
+void UUT_LagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Nothing registered yet, or a client
+	if (Frames.Num() == 0)
+	{
+		return;
+	}
+
+	RecordFrame(FUT_NetTime::GetServerTime(GetWorld()));
+}
+
+TStatId UUT_LagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_LagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_LagCompensationSubsystem::RegisterCharacter(AUnrealTestCharacter* Character)
+{
+	// Allocated once by the first character, recording never allocates
+	if (Frames.Num() == 0)
+	{
+		Frames.SetNum(MAX_FRAMES * MAX_CHARACTERS);
+		FrameTimes.SetNumZeroed(MAX_FRAMES);
+		Characters.SetNumZeroed(MAX_CHARACTERS);
+	}
+
+	const int32 Slot = Characters.Find(nullptr);
+	if (Slot == INDEX_NONE)
+	{
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s is not lag compensated, all %d slots are used"), *GetNameSafe(Character), MAX_CHARACTERS);
+		return;
+	}
+	Characters[Slot] = Character;
+
+	// The slot must not rewind into its previous character
+	for (int32 Frame = 0; Frame < MAX_FRAMES; Frame++)
+	{
+		Frames[Frame * MAX_CHARACTERS + Slot] = FUT_HitboxFrame();
+	}
+}
+
+void UUT_LagCompensationSubsystem::UnregisterCharacter(AUnrealTestCharacter* Character)
+{
+	const int32 Slot = Characters.Find(Character);
+	if (Slot != INDEX_NONE)
+	{
+		Characters[Slot] = nullptr;
+	}
+}
+
+void UUT_LagCompensationSubsystem::RecordFrame(float ServerTime)
+{
+	UT_SCOPE_STAT(LagCompensation);
+
+	HeadFrame = (HeadFrame + 1) % MAX_FRAMES;
+	NumFrames = FMath::Min(NumFrames + 1, MAX_FRAMES);
+	FrameTimes[HeadFrame] = ServerTime;
+
+	FUT_HitboxFrame* Row = &Frames[HeadFrame * MAX_CHARACTERS];
+	for (int32 Slot = 0; Slot < MAX_CHARACTERS; Slot++)
+	{
+		const AUnrealTestCharacter* Character = Characters[Slot];
+		const UCapsuleComponent* Capsule = Character ? Character->GetCapsuleComponent() : nullptr;
+
+		// Dead characters have no collision and cannot be hit
+		if (!Capsule || !Character->GetActorEnableCollision())
+		{
+			Row[Slot] = FUT_HitboxFrame();
+			continue;
+		}
+
+		FUT_HitboxFrame& Hitbox = Row[Slot];
+		Hitbox.CapsuleCenter = FVector3f(Capsule->GetComponentLocation());
+		Hitbox.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		Hitbox.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+
+		// Bones are only fresh on a server when the pose always ticks, otherwise the head sits on top of the capsule
+		const USkeletalMeshComponent* Mesh = Character->GetMesh();
+		if (Mesh && Mesh->VisibilityBasedAnimTickOption == EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones && Mesh->DoesSocketExist(HEAD_SOCKET))
+		{
+			Hitbox.HeadCenter = FVector3f(Mesh->GetSocketLocation(HEAD_SOCKET));
+		}
+		else
+		{
+			Hitbox.HeadCenter = Hitbox.CapsuleCenter + FVector3f(0.f, 0.f, Hitbox.CapsuleHalfHeight - HEAD_RADIUS);
+		}
+	}
+}
+
+bool UUT_LagCompensationSubsystem::FindFrames(float Timestamp, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const
+{
+	if (NumFrames == 0)
+	{
+		return false;
+	}
+
+	// Fairness is bounded, very old shots are tested at the oldest allowed time
+	Timestamp = FMath::Max(Timestamp, FrameTimes[HeadFrame] - MAX_REWIND_TIME);
+
+	// Walk back from the newest row until one is not newer than the shot
+	OutNewerFrame = HeadFrame;
+	for (int32 i = 0; i < NumFrames; i++)
+	{
+		const int32 Frame = (HeadFrame - i + MAX_FRAMES) % MAX_FRAMES;
+		if (FrameTimes[Frame] <= Timestamp)
+		{
+			OutOlderFrame = Frame;
+			const float FrameDelta = FrameTimes[OutNewerFrame] - FrameTimes[Frame];
+			OutAlpha = FrameDelta > KINDA_SMALL_NUMBER ? FMath::Clamp((Timestamp - FrameTimes[Frame]) / FrameDelta, 0.f, 1.f) : 0.f;
+			return true;
+		}
+		OutNewerFrame = Frame;
+	}
+
+	// Older than the whole history
+	OutOlderFrame = OutNewerFrame;
+	OutAlpha = 0.f;
+	return true;
+}
+
+FUT_HitboxFrame UUT_LagCompensationSubsystem::BlendFrames(int32 OlderFrame, int32 NewerFrame, float Alpha, int32 Slot) const
+{
+	const FUT_HitboxFrame& Older = Frames[OlderFrame * MAX_CHARACTERS + Slot];
+	const FUT_HitboxFrame& Newer = Frames[NewerFrame * MAX_CHARACTERS + Slot];
+
+	// Spawns and deaths are not blended
+	if (!Older.IsValid() || !Newer.IsValid())
+	{
+		return Alpha < 0.5f ? Older : Newer;
+	}
+
+	FUT_HitboxFrame Hitbox;
+	Hitbox.CapsuleCenter = FMath::Lerp(Older.CapsuleCenter, Newer.CapsuleCenter, Alpha);
+	Hitbox.HeadCenter = FMath::Lerp(Older.HeadCenter, Newer.HeadCenter, Alpha);
+	Hitbox.CapsuleHalfHeight = FMath::Lerp(Older.CapsuleHalfHeight, Newer.CapsuleHalfHeight, Alpha);
+	Hitbox.CapsuleRadius = FMath::Lerp(Older.CapsuleRadius, Newer.CapsuleRadius, Alpha);
+	return Hitbox;
+}
+
+bool UUT_LagCompensationSubsystem::GetCharacterFrame(const AUnrealTestCharacter* Character, float Timestamp, FUT_HitboxFrame& OutFrame) const
+{
+	const int32 Slot = Characters.IndexOfByKey(Character);
+	int32 OlderFrame, NewerFrame;
+	float Alpha;
+	if (Slot == INDEX_NONE || !FindFrames(Timestamp, OlderFrame, NewerFrame, Alpha))
+	{
+		return false;
+	}
+
+	OutFrame = BlendFrames(OlderFrame, NewerFrame, Alpha, Slot);
+	return OutFrame.IsValid();
+}
+
+bool UUT_LagCompensationSubsystem::RewindTrace(float Timestamp, const FVector& Start, const FVector& End, const AUnrealTestCharacter* IgnoreCharacter, FUT_RewindHit& OutHit) const
+{
+	int32 OlderFrame, NewerFrame;
+	float Alpha;
+	if (Characters.Num() == 0 || !FindFrames(Timestamp, OlderFrame, NewerFrame, Alpha))
+	{
+		return false;
+	}
+
+	UT_SCOPE_STAT(RewindTrace);
+
+	bool bHit = false;
+	OutHit.Distance = TNumericLimits<float>::Max();
+
+	for (int32 Slot = 0; Slot < MAX_CHARACTERS; Slot++)
+	{
+		if (!Characters[Slot] || Characters[Slot] == IgnoreCharacter)
+		{
+			continue;
+		}
+
+		const FUT_HitboxFrame Hitbox = BlendFrames(OlderFrame, NewerFrame, Alpha, Slot);
+		if (!Hitbox.IsValid())
+		{
+			continue;
+		}
+
+		// Head sphere first, then the capsule axis shortened by the radius
+		const FVector HeadCenter(Hitbox.HeadCenter);
+		FVector ShotPoint = FMath::ClosestPointOnSegment(HeadCenter, Start, End);
+		const bool bHeadshot = FVector::DistSquared(ShotPoint, HeadCenter) <= FMath::Square(HEAD_RADIUS);
+		if (!bHeadshot)
+		{
+			const FVector CapsuleCenter(Hitbox.CapsuleCenter);
+			const FVector AxisOffset(0.f, 0.f, FMath::Max(Hitbox.CapsuleHalfHeight - Hitbox.CapsuleRadius, 0.f));
+			FVector AxisPoint;
+			FMath::SegmentDistToSegmentSafe(Start, End, CapsuleCenter - AxisOffset, CapsuleCenter + AxisOffset, ShotPoint, AxisPoint);
+			if (FVector::DistSquared(ShotPoint, AxisPoint) > FMath::Square(Hitbox.CapsuleRadius))
+			{
+				continue;
+			}
+		}
+
+		const float Distance = FVector::Dist(Start, ShotPoint);
+		if (Distance < OutHit.Distance)
+		{
+			OutHit.Character = Characters[Slot];
+			OutHit.Location = ShotPoint;
+			OutHit.Distance = Distance;
+			OutHit.bHeadshot = bHeadshot;
+			bHit = true;
+		}
+	}
+
+	return bHit;
+}
@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Character/UT_MontageTable.h"
+
+#include "Animation/AnimMontage.h"
+
+int32 UUT_MontageTable::FindMontageIndex(const UAnimMontage* Montage) const
+{
+	const int32 MontageIndex = Montages.IndexOfByKey(Montage);
+	return MontageIndex < MAX_MONTAGES ? MontageIndex : INDEX_NONE;
+}
+
+UAnimMontage* UUT_MontageTable::GetMontage(int32 MontageIndex) const
+{
+	return Montages.IsValidIndex(MontageIndex) ? Montages[MontageIndex] : nullptr;
+}
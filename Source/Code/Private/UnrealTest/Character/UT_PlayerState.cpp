@@ -4,18 +4,35 @@
 #include "UnrealTest/Character/UT_PlayerState.h"
 
 #include "Net/UnrealNetwork.h"	
+#include "Net/Core/PushModel/PushModel.h"
 
+#include "UnrealTest/UT_Stats.h"
 #include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Game/UT_DeathMatchGameState.h"
+#include "UnrealTest/Net/UT_PushModel.h"
 
 AUT_PlayerState::AUT_PlayerState()
 {
-	TeamNumber = 0;
+	// No team until the game mode assigns one
+	TeamNumber = INDEX_NONE;
 }
 
 void AUT_PlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(AUT_PlayerState, TeamNumber);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUT_PlayerState, TeamNumber, FUT_PushModel::MakeParams());
+}
+
+void AUT_PlayerState::CopyProperties(APlayerState* PlayerState)
+{
+	Super::CopyProperties(PlayerState);
+
+	// The game mode of the new map counts the team again
+	if (AUT_PlayerState* NewPlayerState = Cast<AUT_PlayerState>(PlayerState))
+	{
+		NewPlayerState->TeamNumber = TeamNumber;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AUT_PlayerState, TeamNumber, NewPlayerState);
+	}
 }
 
 void AUT_PlayerState::OnRep_TeamNumberChanged()
@@ -26,7 +43,24 @@ void AUT_PlayerState::OnRep_TeamNumberChanged()
 
 void AUT_PlayerState::SetTeamNum(int32 NewTeamNumber)
 {
+	if (TeamNumber == NewTeamNumber)
+	{
+		return;
+	}
+
+	UT_SCOPE_STAT(TeamChange);
+
+	// Keep team counters of the game state in sync
+	if (HasAuthority())
+	{
+		if (AUT_DeathMatchGameState* GameState = GetWorld()->GetGameState<AUT_DeathMatchGameState>())
+		{
+			GameState->UpdateTeamCount(TeamNumber, NewTeamNumber);
+		}
+	}
+
 	TeamNumber = NewTeamNumber;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUT_PlayerState, TeamNumber, this);
 	UpdateTeamColors();
 }
 
@@ -35,13 +69,23 @@ int32 AUT_PlayerState::GetTeamNum() const
 	return TeamNumber;
 }
 
+int32 AUT_PlayerState::GetNumDeaths() const
+{
+	int32 Kills = 0, Deaths = 0, Score = 0;
+	if (const AUT_DeathMatchGameState* GameState = GetWorld()->GetGameState<AUT_DeathMatchGameState>())
+	{
+		GameState->GetPlayerScore(this, Kills, Deaths, Score);
+	}
+	return Deaths;
+}
+
 void AUT_PlayerState::UpdateTeamColors() const
 {
 	if (AController* OwnerController = Cast<AController>(GetOwner()))
 	{
 		if (AUnrealTestCharacter* playerChar = Cast<AUnrealTestCharacter>(OwnerController->GetCharacter()))
 		{
-			playerChar->UpdateTeamColors(TeamNumber);
+			playerChar->ApplyTeamColors(TeamNumber);
 		}
 	}
 }
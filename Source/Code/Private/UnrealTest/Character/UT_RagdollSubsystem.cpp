@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Character/UT_RagdollSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+
+bool UUT_RagdollSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Ragdolls are cosmetic
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUT_RagdollSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_UT_NumSimulatedRagdolls, SimulatedCharacters.Num());
+	CSV_CUSTOM_STAT(UnrealTest, SimulatedRagdolls, SimulatedCharacters.Num(), ECsvCustomStatOp::Set);
+
+	if (SimulatedCharacters.Num() == 0)
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	const bool bHasView = GetViewLocation(ViewLocation);
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = SimulatedCharacters.Num() - 1; i >= 0; i--)
+	{
+		AUnrealTestCharacter* Character = SimulatedCharacters[i];
+		if (!IsValid(Character) || !Character->GetMesh())
+		{
+			RemoveAt(i);
+			continue;
+		}
+
+		USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+		// Far bodies get less simulation time
+		const float Distance = bHasView ? FVector::Dist(ViewLocation, Character->GetActorLocation()) : 0.f;
+		const float DistanceAlpha = FMath::Clamp(Distance / MAX_SIMULATE_DISTANCE, 0.f, 1.f);
+		const float SimulateTime = FMath::Lerp(MAX_SIMULATE_TIME, MIN_SIMULATE_TIME, DistanceAlpha);
+
+		if (Mesh->GetPhysicsLinearVelocity().SizeSquared() < FMath::Square(SETTLE_SPEED))
+		{
+			if (SettleStartTimes[i] < 0.f)
+			{
+				SettleStartTimes[i] = Now;
+			}
+		}
+		else
+		{
+			SettleStartTimes[i] = -1.f;
+		}
+
+		// Every body gets to reach the ground before its pose is kept
+		const float Elapsed = Now - StartTimes[i];
+		if (Elapsed < FALL_TIME)
+		{
+			continue;
+		}
+
+		const bool bSettled = SettleStartTimes[i] >= 0.f && Now - SettleStartTimes[i] >= SETTLE_TIME;
+		const bool bExpired = FallOnly[i] || Elapsed >= SimulateTime;
+		const bool bHidden = !Mesh->WasRecentlyRendered(VISIBILITY_TIME);
+
+		if (bSettled || bExpired || bHidden || Distance > MAX_SIMULATE_DISTANCE)
+		{
+			FreezeAt(i);
+		}
+	}
+}
+
+TStatId UUT_RagdollSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_RagdollSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_RagdollSubsystem::RequestRagdoll(AUnrealTestCharacter* Character)
+{
+	if (!Character || !Character->GetMesh() || SimulatedCharacters.Contains(Character))
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	const bool bHasView = GetViewLocation(ViewLocation);
+	const float DistSquared = bHasView ? FVector::DistSquared(ViewLocation, Character->GetActorLocation()) : 0.f;
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// Nobody would see it fall, it only needs to end up lying down
+	bool bFallOnly = DistSquared > FMath::Square(MAX_SIMULATE_DISTANCE) || !Character->GetMesh()->WasRecentlyRendered(VISIBILITY_TIME);
+
+	if (!bFallOnly && SimulatedCharacters.Num() >= MAX_SIMULATED_RAGDOLLS)
+	{
+		// Make room by freezing the farthest body that already fell if this one is closer
+		int32 FarthestIndex = INDEX_NONE;
+		float FarthestDistSquared = -1.f;
+		for (int32 i = 0; i < SimulatedCharacters.Num(); i++)
+		{
+			if (Now - StartTimes[i] < FALL_TIME)
+			{
+				continue;
+			}
+
+			const float OtherDistSquared = IsValid(SimulatedCharacters[i]) ? FVector::DistSquared(ViewLocation, SimulatedCharacters[i]->GetActorLocation()) : MAX_flt;
+			if (OtherDistSquared > FarthestDistSquared)
+			{
+				FarthestIndex = i;
+				FarthestDistSquared = OtherDistSquared;
+			}
+		}
+
+		if (FarthestIndex != INDEX_NONE && FarthestDistSquared > DistSquared)
+		{
+			FreezeAt(FarthestIndex);
+		}
+		else
+		{
+			bFallOnly = true;
+		}
+	}
+
+	Character->StartRagdollSimulation();
+	SimulatedCharacters.Add(Character);
+	StartTimes.Add(Now);
+	SettleStartTimes.Add(-1.f);
+	FallOnly.Add(bFallOnly);
+}
+
+void UUT_RagdollSubsystem::ReleaseRagdoll(AUnrealTestCharacter* Character)
+{
+	const int32 Index = SimulatedCharacters.Find(Character);
+	if (Index != INDEX_NONE)
+	{
+		RemoveAt(Index);
+	}
+}
+
+bool UUT_RagdollSubsystem::GetViewLocation(FVector& OutLocation) const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController && PlayerController->IsLocalController())
+	{
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+		return true;
+	}
+	return false;
+}
+
+void UUT_RagdollSubsystem::FreezeAt(int32 Index)
+{
+	if (IsValid(SimulatedCharacters[Index]))
+	{
+		SimulatedCharacters[Index]->FreezeRagdollPose();
+	}
+	RemoveAt(Index);
+}
+
+void UUT_RagdollSubsystem::RemoveAt(int32 Index)
+{
+	SimulatedCharacters.RemoveAtSwap(Index, 1, false);
+	StartTimes.RemoveAtSwap(Index, 1, false);
+	SettleStartTimes.RemoveAtSwap(Index, 1, false);
+	FallOnly.RemoveAtSwap(Index, 1, false);
+}
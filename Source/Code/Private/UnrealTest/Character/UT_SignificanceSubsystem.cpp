@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Character/UT_SignificanceSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/SpringArmComponent.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Character/UT_PlayerState.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+
+bool UUT_SignificanceSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only rendering clients pay for remote characters
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUT_SignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Characters.Num() == 0)
+	{
+		return;
+	}
+
+	UT_SCOPE_STAT(Significance);
+
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->IsLocalController())
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const AUT_PlayerState* LocalPlayerState = PlayerController->GetPlayerState<AUT_PlayerState>();
+	const int32 LocalTeamNum = LocalPlayerState ? LocalPlayerState->GetTeamNum() : INDEX_NONE;
+
+	for (int32 i = Characters.Num() - 1; i >= 0; i--)
+	{
+		AUnrealTestCharacter* Character = Characters[i];
+		if (!IsValid(Character) || !Character->GetMesh())
+		{
+			RemoveAt(i);
+			continue;
+		}
+
+		// Ragdolls are budgeted by UUT_RagdollSubsystem and need every mesh tick
+		EUT_Significance Significance = EUT_Significance::High;
+		if (Character->IsLocallyControlled())
+		{
+			Significance = EUT_Significance::Local;
+		}
+		else if (!Character->GetMesh()->IsSimulatingPhysics())
+		{
+			const float Score = GetSignificance(Character, ViewLocation, LocalTeamNum);
+			if (Score < MEDIUM_SIGNIFICANCE)
+			{
+				Significance = EUT_Significance::Low;
+			}
+			else if (Score < HIGH_SIGNIFICANCE)
+			{
+				Significance = EUT_Significance::Medium;
+			}
+		}
+
+		if (Significance != Significances[i])
+		{
+			ApplySignificance(Character, Significance, i);
+			Significances[i] = Significance;
+		}
+	}
+}
+
+TStatId UUT_SignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_SignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_SignificanceSubsystem::RegisterCharacter(AUnrealTestCharacter* Character)
+{
+	// Authoritative characters are simulated and lag compensated by this machine, e.g. on a listen server
+	if (!Character || !Character->GetMesh() || Character->HasAuthority() || Characters.Contains(Character))
+	{
+		return;
+	}
+
+	// Lets the engine skip anim frames on top of the significance levels
+	Character->GetMesh()->bEnableUpdateRateOptimizations = true;
+
+	Characters.Add(Character);
+	Significances.Add(EUT_Significance::None);
+	DefaultMeshOverlaps.Add(Character->GetMesh()->GetGenerateOverlapEvents());
+	DefaultAnimTickOptions.Add(Character->GetMesh()->VisibilityBasedAnimTickOption);
+}
+
+void UUT_SignificanceSubsystem::UnregisterCharacter(AUnrealTestCharacter* Character)
+{
+	const int32 Index = Characters.Find(Character);
+	if (Index != INDEX_NONE)
+	{
+		RemoveAt(Index);
+	}
+}
+
+void UUT_SignificanceSubsystem::RemoveAt(int32 Index)
+{
+	Characters.RemoveAtSwap(Index, 1, false);
+	Significances.RemoveAtSwap(Index, 1, false);
+	DefaultMeshOverlaps.RemoveAtSwap(Index, 1, false);
+	DefaultAnimTickOptions.RemoveAtSwap(Index, 1, false);
+}
+
+float UUT_SignificanceSubsystem::GetSignificance(const AUnrealTestCharacter* Character, const FVector& ViewLocation, int32 LocalTeamNum) const
+{
+	const float Distance = FVector::Dist(ViewLocation, Character->GetActorLocation());
+	float Score = 1.f - FMath::Clamp(Distance / MAX_SIGNIFICANCE_DISTANCE, 0.f, 1.f);
+
+	if (!Character->GetMesh()->WasRecentlyRendered(VISIBILITY_TIME))
+	{
+		Score *= HIDDEN_SCALE;
+	}
+
+	// Enemies are the ones worth watching
+	if (LocalTeamNum != INDEX_NONE && Character->GetPlayerTeam() == LocalTeamNum)
+	{
+		Score *= TEAMMATE_SCALE;
+	}
+
+	return Score;
+}
+
+void UUT_SignificanceSubsystem::ApplySignificance(AUnrealTestCharacter* Character, EUT_Significance Significance, int32 Index) const
+{
+	float TickInterval = 0.f;
+	if (Significance == EUT_Significance::Medium)
+	{
+		TickInterval = MEDIUM_TICK_INTERVAL;
+	}
+	else if (Significance == EUT_Significance::Low)
+	{
+		TickInterval = LOW_TICK_INTERVAL;
+	}
+
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+	Mesh->SetComponentTickInterval(TickInterval);
+	// Options are ordered from most to least ticking, low never ticks more than the default
+	const EVisibilityBasedAnimTickOption DefaultAnimTickOption = DefaultAnimTickOptions[Index];
+	Mesh->VisibilityBasedAnimTickOption = Significance == EUT_Significance::Low
+		? FMath::Max(DefaultAnimTickOption, EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered)
+		: DefaultAnimTickOption;
+	Mesh->SetGenerateOverlapEvents(DefaultMeshOverlaps[Index] && Significance != EUT_Significance::Low);
+
+	if (UCharacterMovementComponent* CharacterMovement = Character->GetCharacterMovement())
+	{
+		CharacterMovement->SetComponentTickInterval(TickInterval);
+	}
+
+	// Only the local camera needs its boom
+	if (USpringArmComponent* CameraBoom = Character->GetCameraBoom())
+	{
+		CameraBoom->SetComponentTickEnabled(Significance == EUT_Significance::Local);
+	}
+}
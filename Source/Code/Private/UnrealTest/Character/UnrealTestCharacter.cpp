@@ -2,20 +2,40 @@
 
 #include "UnrealTest/Character/UnrealTestCharacter.h"
 
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
 #include "Camera/CameraComponent.h"
+#include "Materials/MaterialInterface.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
 
+#include "UnrealTest/UT_Stats.h"
 #include "UnrealTest/Game/UT_DeathMatchGameMode.h"
+#include "UnrealTest/Game/UT_GameplayAssets.h"
+#include "UnrealTest/Game/UT_GameplayAssetsSubsystem.h"
+#include "UnrealTest/Character/UT_CharacterMovementComponent.h"
 #include "UnrealTest/Character/UT_PlayerState.h"
-
+#include "UnrealTest/Character/UT_LagCompensationSubsystem.h"
+#include "UnrealTest/Character/UT_MontageTable.h"
+#include "UnrealTest/Character/UT_RagdollSubsystem.h"
+#include "UnrealTest/Character/UT_SignificanceSubsystem.h"
+#include "UnrealTest/Net/UT_NetCounters.h"
+#include "UnrealTest/Net/UT_NetTime.h"
+#include "UnrealTest/Net/UT_PushModel.h"
+
+#include "UnrealTest/Game/UT_InteractionSubsystem.h"
 #include "UnrealTest/Items/Door.h"
 
-AUnrealTestCharacter::AUnrealTestCharacter()
+AUnrealTestCharacter::AUnrealTestCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UUT_CharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
@@ -27,17 +47,29 @@ AUnrealTestCharacter::AUnrealTestCharacter()
 
 	ConfigureCharacterMovement(GetCharacterMovement());
 	
+	// Created in every build so cooked Blueprints match the native archetypes, see PostInitializeComponents
 	SetCameraBoom();
 	SetFollowCamera();
+
+	AppliedTeamColor = INDEX_NONE;
+	bIsParked = false;
 	
 	bReplicates = true;
 	// Note: The skeletal mesh and anim blueprint references on the Mesh component (inherited from Character) 
 	// are set in the derived blueprint asset named ThirdPersonCharacter (to avoid direct content references in C++)
 
-	GetCapsuleComponent()->OnComponentBeginOverlap.AddDynamic(this, &AUnrealTestCharacter::OnOverlapBegin);
-	GetCapsuleComponent()->OnComponentEndOverlap.AddDynamic(this, &AUnrealTestCharacter::OnOverlapEnd);
+	// Interactables are queried on demand through UUT_InteractionSubsystem
+	GetCapsuleComponent()->SetGenerateOverlapEvents(false);
 
-	CurrentDoor = nullptr;
+	MontageTable = nullptr;
+}
+
+void AUnrealTestCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUnrealTestCharacter, CurrentMontage, FUT_PushModel::MakeParams());
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUnrealTestCharacter, bIsParked, FUT_PushModel::MakeParams());
 }
 
 void AUnrealTestCharacter::DisableControllerRotation()
@@ -80,29 +112,6 @@ void AUnrealTestCharacter::SetFollowCamera()
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 }
 
-void AUnrealTestCharacter::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	if (OtherActor != nullptr && OtherActor != this && OtherComp != nullptr && OtherActor->GetClass()->IsChildOf(ADoor::StaticClass()))
-	{
-		CurrentDoor = Cast<ADoor>(OtherActor);
-	}
-}
-
-void AUnrealTestCharacter::OnOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
-{
-	if (OtherActor != nullptr && OtherActor != this && OtherComp != nullptr)
-	{
-		CurrentDoor = nullptr;
-	}
-}
-
-void AUnrealTestCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(AUnrealTestCharacter, CurrentDoor);
-}
-
 //////////////////////////////////////////////////////////////////////////
 // Input
 
@@ -171,14 +180,70 @@ void AUnrealTestCharacter::TouchStopped(ETouchIndex::Type FingerIndex, FVector L
 	StopJumping();
 }
 
+void AUnrealTestCharacter::ApplyTeamColors(int32 TeamNum)
+{
+	// Cosmetic, the materials are not even loaded on dedicated servers
+	if (TeamNum == AppliedTeamColor || !GetMesh() || ShouldSkipCosmetics())
+	{
+		return;
+	}
+
+	UT_SCOPE_STAT(TeamColors);
+	AppliedTeamColor = TeamNum;
+
+	const UUT_GameplayAssets* GameplayAssets = UUT_GameplayAssetsSubsystem::FindGameplayAssets(GetWorld());
+	if (!GameplayAssets->TeamMaterials.IsValidIndex(TeamNum))
+	{
+		UpdateTeamColors(TeamNum);
+		return;
+	}
+
+	// Normally preloaded with the cosmetic bundle, otherwise applied once streamed in
+	TArray<FSoftObjectPath> PendingMaterials;
+	for (const TSoftObjectPtr<UMaterialInterface>& Material : GameplayAssets->TeamMaterials[TeamNum].Materials)
+	{
+		if (Material.IsPending())
+		{
+			PendingMaterials.Add(Material.ToSoftObjectPath());
+		}
+	}
+
+	if (PendingMaterials.Num() > 0)
+	{
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(PendingMaterials, FStreamableDelegate::CreateUObject(this, &AUnrealTestCharacter::SetTeamMaterials, TeamNum));
+		return;
+	}
+
+	SetTeamMaterials(TeamNum);
+}
+
+void AUnrealTestCharacter::SetTeamMaterials(int32 TeamNum)
+{
+	// Team may have changed while the materials streamed in
+	if (TeamNum != AppliedTeamColor || !GetMesh())
+	{
+		return;
+	}
+
+	// Shared instances keep draw calls of a team batchable, no per character material is created
+	const TArray<TSoftObjectPtr<UMaterialInterface>>& Materials = UUT_GameplayAssetsSubsystem::FindGameplayAssets(GetWorld())->TeamMaterials[TeamNum].Materials;
+	for (int32 Slot = 0; Slot < Materials.Num(); Slot++)
+	{
+		if (UMaterialInterface* Material = Materials[Slot].Get())
+		{
+			GetMesh()->SetMaterial(Slot, Material);
+		}
+	}
+}
+
 void AUnrealTestCharacter::OnAction()
 {
-	if (CurrentDoor)
+	// Server runs the same query again before toggling
+	if (ADoor* Door = FindInteractionDoor())
 	{
-		const FVector ForwardVector = FollowCamera->GetForwardVector();
 		if (HasAuthority())
 		{
-			CurrentDoor->ToggleDoor(ForwardVector);
+			Door->ToggleDoor(GetBaseAimRotation().Vector());
 		}
 		else
 		{
@@ -187,8 +252,20 @@ void AUnrealTestCharacter::OnAction()
 	}
 }
 
+ADoor* AUnrealTestCharacter::FindInteractionDoor() const
+{
+	UT_SCOPE_STAT(Interaction);
+
+	if (UUT_InteractionSubsystem* Interaction = GetWorld()->GetSubsystem<UUT_InteractionSubsystem>())
+	{
+		return Interaction->FindBestDoor(GetActorLocation(), GetBaseAimRotation().Vector());
+	}
+	return nullptr;
+}
+
 void AUnrealTestCharacter::Server_OnAction_Implementation()
 {
+	FUT_NetCounters::ServerRpcs++;
 	OnAction();
 }
 
@@ -209,6 +286,58 @@ void AUnrealTestCharacter::LookUpAtRate(float Rate)
 	AddControllerPitchInput(Rate * TurnRateGamepad * GetWorld()->GetDeltaSeconds());
 }
 
+void AUnrealTestCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Nothing views through the camera of a dedicated server
+	if (ShouldSkipCosmetics())
+	{
+		if (CameraBoom)
+		{
+			CameraBoom->SetComponentTickEnabled(false);
+			CameraBoom->UnregisterComponent();
+		}
+		if (FollowCamera)
+		{
+			FollowCamera->UnregisterComponent();
+		}
+	}
+}
+
+void AUnrealTestCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		if (UUT_LagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUT_LagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+
+	if (UUT_SignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UUT_SignificanceSubsystem>())
+	{
+		Significance->RegisterCharacter(this);
+	}
+}
+
+void AUnrealTestCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUT_LagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<UUT_LagCompensationSubsystem>())
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+
+	if (UUT_SignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UUT_SignificanceSubsystem>())
+	{
+		Significance->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AUnrealTestCharacter::PossessedBy(AController* C)
 {
 	Super::PossessedBy(C);
@@ -216,7 +345,7 @@ void AUnrealTestCharacter::PossessedBy(AController* C)
 	//Update Colors in server
 	if (AUT_PlayerState* playerState = Cast<AUT_PlayerState>(GetPlayerState()))
 	{
-		UpdateTeamColors(playerState->GetTeamNum());
+		ApplyTeamColors(playerState->GetTeamNum());
 	}
 }
 
@@ -229,7 +358,7 @@ void AUnrealTestCharacter::OnRep_PlayerState()
 	{
 		if (AUT_PlayerState* playerState = Cast<AUT_PlayerState>(GetPlayerState()))
 		{
-			UpdateTeamColors(playerState->GetTeamNum());
+			ApplyTeamColors(playerState->GetTeamNum());
 		}
 	}
 }
@@ -265,11 +394,28 @@ void AUnrealTestCharacter::MoveRight(float Value)
 
 void AUnrealTestCharacter::Multicast_ApplyRagdoll_Implementation()
 {
-	if (!GetMesh())
+	UT_SCOPE_STAT(Ragdoll);
+	INC_DWORD_STAT(STAT_UT_NumRagdollRpcs);
+
+	if (HasAuthority())
+	{
+		FUT_NetCounters::MulticastRpcs++;
+	}
+
+	// Ragdolls are cosmetic, nobody sees them on a dedicated server
+	if (!GetMesh() || ShouldSkipCosmetics())
 	{
 		return;
 	}
 
+	if (UUT_RagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UUT_RagdollSubsystem>())
+	{
+		Ragdolls->RequestRagdoll(this);
+	}
+}
+
+void AUnrealTestCharacter::StartRagdollSimulation()
+{
 	//Set Collison Preset to Ragdoll
 	GetMesh()->SetCollisionProfileName(TEXT("Ragdoll"));
 	SetActorEnableCollision(true);
@@ -282,14 +428,35 @@ void AUnrealTestCharacter::Multicast_ApplyRagdoll_Implementation()
 	GetMesh()->AddImpulseAtLocation(GetActorForwardVector() * -1000, GetActorLocation());
 }
 
+void AUnrealTestCharacter::FreezeRagdollPose()
+{
+	// Keep the last pose without simulating or animating
+	GetMesh()->SetAllBodiesSimulatePhysics(false);
+	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->bNoSkeletonUpdate = true;
+	GetMesh()->SetComponentTickEnabled(false);
+}
+
 void AUnrealTestCharacter::Multicast_ReAttachRagdoll_Implementation()
 {
-	if (!GetMesh())
+	if (HasAuthority())
+	{
+		FUT_NetCounters::MulticastRpcs++;
+	}
+
+	if (!GetMesh() || ShouldSkipCosmetics())
 	{
 		return;
 	}
 
+	if (UUT_RagdollSubsystem* Ragdolls = GetWorld()->GetSubsystem<UUT_RagdollSubsystem>())
+	{
+		Ragdolls->ReleaseRagdoll(this);
+	}
+
 	GetMesh()->SetSimulatePhysics(false);
+	GetMesh()->bNoSkeletonUpdate = false;
+	GetMesh()->SetComponentTickEnabled(true);
 
 	//Default Relative Loc of the player in viewport
 	FVector relativeLoc = GetCapsuleComponent()->GetComponentLocation();
@@ -303,15 +470,127 @@ void AUnrealTestCharacter::Multicast_ReAttachRagdoll_Implementation()
 	GetMesh()->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepWorldTransform);
 }
 
-void AUnrealTestCharacter::Multicast_PlayAnimation_Implementation(UAnimMontage* MontageToPlay)
+void AUnrealTestCharacter::PlayAnimation(UAnimMontage* MontageToPlay)
 {
-	if (GetMesh())
+	if (!HasAuthority() || !MontageTable)
 	{
-		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-		if (AnimInstance)
-		{
-			AnimInstance->Montage_Play(MontageToPlay);
-		}
+		return;
+	}
+
+	const int32 MontageIndex = MontageTable->FindMontageIndex(MontageToPlay);
+	if (MontageIndex == INDEX_NONE)
+	{
+		UE_LOG(LogUnrealTest, Warning, TEXT("%s is not in the montage table of %s"), *GetNameSafe(MontageToPlay), *GetName());
+		return;
+	}
+
+	CurrentMontage.MontageIndex = static_cast<uint8>(MontageIndex);
+	CurrentMontage.StartTime = FUT_NetTime::Quantize(FUT_NetTime::GetServerTime(GetWorld()));
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUnrealTestCharacter, CurrentMontage, this);
+
+	// StartTime wraps every ~655 seconds, late joiners must not take an old montage for a playing one
+	GetWorldTimerManager().SetTimer(MontageEndTimer, this, &AUnrealTestCharacter::ClearCurrentMontage, MontageToPlay->GetPlayLength(), false);
+
+	Multicast_PlayAnimation(CurrentMontage.MontageIndex, CurrentMontage.StartTime);
+}
+
+void AUnrealTestCharacter::ClearCurrentMontage()
+{
+	CurrentMontage = FUT_MontageState();
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUnrealTestCharacter, CurrentMontage, this);
+}
+
+void AUnrealTestCharacter::Multicast_PlayAnimation_Implementation(uint8 MontageIndex, uint16 StartTime)
+{
+	if (HasAuthority())
+	{
+		FUT_NetCounters::MulticastRpcs++;
+	}
+
+	FUT_MontageState MontageState;
+	MontageState.MontageIndex = MontageIndex;
+	MontageState.StartTime = StartTime;
+	PlayMontageState(MontageState);
+}
+
+void AUnrealTestCharacter::OnRep_CurrentMontage()
+{
+	PlayMontageState(CurrentMontage);
+}
+
+void AUnrealTestCharacter::PlayMontageState(const FUT_MontageState& MontageState)
+{
+	// The multicast and the property may both arrive, montages are cosmetic
+	if (MontageState == PlayedMontage || !MontageTable || !GetMesh() || ShouldSkipCosmetics())
+	{
+		return;
+	}
+	PlayedMontage = MontageState;
+
+	UT_SCOPE_STAT(Montage);
+
+	UAnimMontage* MontageToPlay = MontageTable->GetMontage(MontageState.MontageIndex);
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!MontageToPlay || !AnimInstance)
+	{
+		return;
+	}
+
+	// Start where the server is, skip montages that are already over
+	const float ElapsedTime = FUT_NetTime::GetElapsed(MontageState.StartTime, FUT_NetTime::GetServerTime(GetWorld()));
+	if (ElapsedTime < MontageToPlay->GetPlayLength())
+	{
+		AnimInstance->Montage_Play(MontageToPlay, 1.f, EMontagePlayReturnType::MontageLength, ElapsedTime);
+	}
+}
+
+void AUnrealTestCharacter::ParkInPool()
+{
+	bIsParked = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUnrealTestCharacter, bIsParked, this);
+	ApplyParkedState();
+}
+
+void AUnrealTestCharacter::ReuseFromPool(const FTransform& SpawnTransform)
+{
+	bIsParked = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUnrealTestCharacter, bIsParked, this);
+
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.Rotator(), false, nullptr, ETeleportType::ResetPhysics);
+
+	// Mesh may still lie where the previous life ended
+	Multicast_ReAttachRagdoll();
+
+	ApplyParkedState();
+
+	// Nothing of the previous life is replayed
+	GetWorldTimerManager().ClearTimer(MontageEndTimer);
+	ClearCurrentMontage();
+}
+
+void AUnrealTestCharacter::OnRep_IsParked()
+{
+	// Clients would otherwise keep an invisible capsule where the pawn was parked
+	ApplyParkedState();
+}
+
+void AUnrealTestCharacter::ApplyParkedState()
+{
+	if (bIsParked)
+	{
+		DisableMovement();
+		DisableCapsuleCollision();
+
+		// Hidden without collision, also skipped by lag compensation
+		SetActorHiddenInGame(true);
+		SetActorEnableCollision(false);
+	}
+	else
+	{
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(true);
+		EnableCapsuleCollision();
+		EnableMovement();
 	}
 }
 
@@ -3,8 +3,30 @@
 
 #include "UnrealTest/Components/UT_CustomPlayerStart.h"
 
+#include "UnrealTest/Game/UT_SpawnPointSubsystem.h"
+
 AUT_CustomPlayerStart::AUT_CustomPlayerStart(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	SpawnTeam = -1;
 }
+
+void AUT_CustomPlayerStart::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UUT_SpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UUT_SpawnPointSubsystem>())
+	{
+		SpawnPoints->RegisterStart(this);
+	}
+}
+
+void AUT_CustomPlayerStart::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUT_SpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UUT_SpawnPointSubsystem>())
+	{
+		SpawnPoints->UnregisterStart(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
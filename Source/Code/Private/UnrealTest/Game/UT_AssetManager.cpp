@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_AssetManager.h"
+
+#include "UnrealTest/Game/UT_GameplayAssets.h"
+
+#if WITH_EDITOR
+void UUT_AssetManager::ModifyCook(TConstArrayView<const ITargetPlatform*> TargetPlatforms, TArray<FName>& PackagesToCook, TArray<FName>& PackagesToNeverCook)
+{
+	Super::ModifyCook(TargetPlatforms, PackagesToCook, PackagesToNeverCook);
+
+	// Authored data assets are cooked by their AlwaysCook rule along with their bundles
+	TArray<FPrimaryAssetId> AssetIds;
+	GetPrimaryAssetIdList(UUT_GameplayAssets::PRIMARY_ASSET_TYPE, AssetIds);
+	if (AssetIds.Num() > 0)
+	{
+		return;
+	}
+
+	// The class defaults are never saved, so the cooker cannot follow their soft references
+	TArray<FSoftObjectPath> Paths;
+	GetDefault<UUT_GameplayAssets>()->GetBundlePaths({ UUT_GameplayAssets::GAMEPLAY_BUNDLE, UUT_GameplayAssets::COSMETIC_BUNDLE }, Paths);
+	for (const FSoftObjectPath& Path : Paths)
+	{
+		PackagesToCook.AddUnique(FName(*Path.GetLongPackageName()));
+	}
+}
+#endif
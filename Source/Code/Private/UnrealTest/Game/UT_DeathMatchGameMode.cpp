@@ -2,14 +2,18 @@
 
 #include "UnrealTest/Game/UT_DeathMatchGameMode.h"
 
-#include "EngineUtils.h"
 #include "GameFramework/PlayerStart.h"
 #include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
 
+#include "UnrealTest/UT_Stats.h"
 #include "UnrealTest/Character/UT_PlayerState.h"
 #include "UnrealTest/Character/UnrealTestCharacter.h"
 #include "UnrealTest/Game/UT_DeathMatchGameState.h"
+#include "UnrealTest/Game/UT_SpawnPointSubsystem.h"
 #include "UnrealTest/Components/UT_CustomPlayerStart.h"
+#include "UnrealTest/Net/UT_NetTime.h"
 
 AUT_DeathMatchGameMode::AUT_DeathMatchGameMode(const FObjectInitializer& ObjectInitializer)
 	:Super(ObjectInitializer)
@@ -19,87 +23,310 @@ AUT_DeathMatchGameMode::AUT_DeathMatchGameMode(const FObjectInitializer& ObjectI
 	GameStateClass = AUT_DeathMatchGameState::StaticClass();
 
 	NumTeams = 2;
+
+	// Warmup until enough players joined, then countdown
+	bDelayedStart = true;
+	PlayerNumberToStartGame = 2;
+	CountdownTime = 10.f;
+	MatchTime = 600.f;
+	PostMatchTime = 10.f;
+
+	MaxPooledPawns = 16;
+
+	// Keep connections and player states between matches
+	bUseSeamlessTravel = true;
+}
+
+void AUT_DeathMatchGameMode::ScoreKill(AController* Killer, AController* Victim)
+{
+	if (!IsMatchInProgress() || !Victim)
+	{
+		return;
+	}
+
+	if (AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>())
+	{
+		DeathMatchGameState->ScoreKill(Killer ? Killer->PlayerState : nullptr, Victim->PlayerState);
+	}
+}
+
+void AUT_DeathMatchGameMode::ReleasePawn(AUnrealTestCharacter* Character)
+{
+	if (!Character || Character->IsParked())
+	{
+		return;
+	}
+
+	if (AController* Controller = Character->GetController())
+	{
+		Controller->UnPossess();
+	}
+
+	if (PawnPool.Num() >= MaxPooledPawns)
+	{
+		Character->Destroy();
+		return;
+	}
+
+	Character->ParkInPool();
+	PawnPool.Add(Character);
+}
+
+void AUT_DeathMatchGameMode::InitGameState()
+{
+	Super::InitGameState();
+
+	if (AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>())
+	{
+		DeathMatchGameState->SetNumTeams(NumTeams);
+	}
+}
+
+FString AUT_DeathMatchGameMode::InitNewPlayer(APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal)
+{
+	// Set Team once, before the initial start is chosen
+	if (AUT_PlayerState* NewPlayerState = NewPlayerController->GetPlayerState<AUT_PlayerState>())
+	{
+		if (NewPlayerState->GetTeamNum() == INDEX_NONE)
+		{
+			NewPlayerState->SetTeamNum(ChooseTeam(NewPlayerState));
+		}
+	}
+
+	return Super::InitNewPlayer(NewPlayerController, UniqueId, Options, Portal);
+}
+
+void AUT_DeathMatchGameMode::Logout(AController* Exiting)
+{
+	// Free the slot in the team counters
+	if (AUT_PlayerState* ExitingPlayerState = Exiting->GetPlayerState<AUT_PlayerState>())
+	{
+		ExitingPlayerState->SetTeamNum(INDEX_NONE);
+	}
+
+	Super::Logout(Exiting);
+
+	CheckPlayerThreshold();
 }
 
 AActor* AUT_DeathMatchGameMode::ChoosePlayerStart_Implementation(AController* Player)
 {
-	//Set Team
-	AUT_PlayerState* NewPlayerState = Cast<AUT_PlayerState>(Player->PlayerState);
-	const int32 TeamNum = ChooseTeam(NewPlayerState);
-	NewPlayerState->SetTeamNum(TeamNum);
-	
-	//Choose start
-	TArray<APlayerStart*> PossibleSpawns;
+	UT_SCOPE_STAT(ChoosePlayerStart);
+	INC_DWORD_STAT(STAT_UT_NumSpawns);
+
+	// Team was assigned at login
+	AUT_PlayerState* PlayerState = Player ? Player->GetPlayerState<AUT_PlayerState>() : nullptr;
+	const int32 TeamNum = PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+
+	//Choose start from the team bucket of the registry
 	APlayerStart* BestStart = nullptr;
+	if (UUT_SpawnPointSubsystem* SpawnPoints = GetWorld()->GetSubsystem<UUT_SpawnPointSubsystem>())
+	{
+		BestStart = SpawnPoints->ClaimStart(TeamNum);
+	}
 
-	//Get All SpawnPoints from map
-	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	// In case no best start start by default
+	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
+}
+
+bool AUT_DeathMatchGameMode::HasMatchStarted() const
+{
+	return GetMatchState() != UT_MatchState::Countdown && Super::HasMatchStarted();
+}
+
+void AUT_DeathMatchGameMode::OnMatchStateSet()
+{
+	GetWorldTimerManager().ClearTimer(MatchStateTimer);
+
+	Super::OnMatchStateSet();
+
+	// Timed states end by themselves
+	FTimerDelegate StateEnd;
+	float StateTime = 0.f;
+	if (MatchState == UT_MatchState::Countdown)
+	{
+		StateEnd.BindUObject(this, &AUT_DeathMatchGameMode::StartMatch);
+		StateTime = CountdownTime;
+	}
+	else if (MatchState == MatchState::InProgress && MatchTime > 0.f)
 	{
-		APlayerStart* start = *It;
-		if (start->IsA<AUT_CustomPlayerStart>())
+		StateEnd.BindUObject(this, &AUT_DeathMatchGameMode::EndMatch);
+		StateTime = MatchTime;
+	}
+	else if (MatchState == MatchState::WaitingPostMatch)
+	{
+		StateEnd.BindUObject(this, &AUT_DeathMatchGameMode::TravelToNextMap);
+		StateTime = PostMatchTime;
+	}
+
+	float StateEndTime = 0.f;
+	if (StateEnd.IsBound())
+	{
+		StateTime = FMath::Max(StateTime, KINDA_SMALL_NUMBER);
+		GetWorldTimerManager().SetTimer(MatchStateTimer, StateEnd, StateTime, false);
+		StateEndTime = FUT_NetTime::GetServerTime(GetWorld()) + StateTime;
+	}
+
+	if (AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>())
+	{
+		DeathMatchGameState->SetMatchStateEndTime(StateEndTime);
+	}
+}
+
+void AUT_DeathMatchGameMode::HandleMatchHasStarted()
+{
+	// Warmup pawns are parked and respawned at the team starts
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr)
 		{
-			//Check team restrictions
-			if (CheckStartTeam(start, Player))
+			if (AUnrealTestCharacter* Character = Cast<AUnrealTestCharacter>(Pawn))
+			{
+				ReleasePawn(Character);
+			}
+			else
 			{
-				PossibleSpawns.Add(start);
+				PlayerController->UnPossess();
+				Pawn->Destroy();
 			}
 		}
 	}
 
-	//Choose Random Start Position
-	if (!BestStart)
+	Super::HandleMatchHasStarted();
+
+	// Warmup kills do not count
+	if (AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>())
 	{
-		if (PossibleSpawns.Num() > 0)
-		{
-			BestStart = PossibleSpawns[FMath::RandHelper(PossibleSpawns.Num())];
-		}
+		DeathMatchGameState->ResetScores();
 	}
-	// In case no best start start by default
-	return BestStart ? BestStart : Super::ChoosePlayerStart_Implementation(Player);
+
+	OnMatchStart.Broadcast();
+
+	// Performance summary covers this match only
+	FUT_MatchStats::Reset(GetWorld()->GetTimeSeconds());
+}
+
+void AUT_DeathMatchGameMode::HandleMatchHasEnded()
+{
+	Super::HandleMatchHasEnded();
+
+	OnMatchEnd.Broadcast();
+
+	FUT_MatchStats::Dump(*GLog, GetWorld()->GetTimeSeconds());
 }
 
-bool AUT_DeathMatchGameMode::CheckStartTeam(APlayerStart* PlayerStart, AController* Player) const
+bool AUT_DeathMatchGameMode::PlayerCanRestart_Implementation(APlayerController* Player)
 {
-	if (Player)
+	// AGameMode only restarts players once the match is in progress
+	if (GetMatchState() == MatchState::WaitingToStart || GetMatchState() == UT_MatchState::Countdown)
 	{
-		AUT_CustomPlayerStart* customStart = Cast<AUT_CustomPlayerStart>(PlayerStart);
-		AUT_PlayerState* playerState = Cast<AUT_PlayerState>(Player->PlayerState);
+		return Player && !Player->IsPendingKillPending() && !MustSpectate(Player) && Player->CanRestartPlayer();
+	}
+	return Super::PlayerCanRestart_Implementation(Player);
+}
 
-		if (playerState && customStart && customStart->GetSpawnTeam() == playerState->GetTeamNum())
+APawn* AUT_DeathMatchGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	// No construction on the respawn path when a parked character of the right class is available
+	UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+	for (int32 i = PawnPool.Num() - 1; i >= 0; i--)
+	{
+		AUnrealTestCharacter* Character = PawnPool[i];
+		if (!IsValid(Character))
+		{
+			PawnPool.RemoveAtSwap(i, 1, false);
+		}
+		else if (Character->GetClass() == PawnClass)
 		{
-			return true;
+			PawnPool.RemoveAtSwap(i, 1, false);
+			Character->ReuseFromPool(SpawnTransform);
+			return Character;
 		}
 	}
-	return false;
+
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
 }
 
 void AUT_DeathMatchGameMode::HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer)
 {
 	Super::HandleStartingNewPlayer_Implementation(NewPlayer);
 
-	if (NumPlayers == 2)
+	// AGameMode leaves players without a pawn until the match starts
+	if (!HasMatchStarted() && !NewPlayer->GetPawn() && PlayerCanRestart(NewPlayer))
 	{
-		OnMatchStart.Broadcast();
-		StartMatch();
+		RestartPlayer(NewPlayer);
 	}
+
+	CheckPlayerThreshold();
 }
 
-int32 AUT_DeathMatchGameMode::ChooseTeam(AUT_PlayerState* PlayerState) const
+void AUT_DeathMatchGameMode::InitSeamlessTravelPlayer(AController* NewController)
 {
-	int32 PlayersTeam0 = 0;
-	int32 PlayersTeam1 = 0;
-
-	// Array of all Player States
-	for (int32 i = 0; i < GameState->PlayerArray.Num(); i++)
+	// Team was copied from the previous map, count it before the start spot is chosen
+	if (AUT_PlayerState* PlayerState = NewController->GetPlayerState<AUT_PlayerState>())
 	{
-		if (AUT_PlayerState* State = Cast<AUT_PlayerState>(GameState->PlayerArray[i]))
+		AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>();
+		const int32 PreviousTeam = PlayerState->GetTeamNum();
+		if (DeathMatchGameState && PreviousTeam >= 0 && PreviousTeam < DeathMatchGameState->GetNumTeams())
+		{
+			DeathMatchGameState->UpdateTeamCount(INDEX_NONE, PreviousTeam);
+		}
+		else
 		{
-			// Add one in case 
-			State->GetTeamNum() == 0 ? PlayersTeam0++ : PlayersTeam1++;
+			PlayerState->SetTeamNum(ChooseTeam(PlayerState));
 		}
 	}
-	
-	// return the index of the team least populated
-	return PlayersTeam0 <= PlayersTeam1 ? 0 : 1;
+
+	Super::InitSeamlessTravelPlayer(NewController);
+}
+
+void AUT_DeathMatchGameMode::HandleSeamlessTravelPlayer(AController*& C)
+{
+	Super::HandleSeamlessTravelPlayer(C);
+
+	// Travelling players are only counted once they arrive
+	CheckPlayerThreshold();
+}
+
+void AUT_DeathMatchGameMode::CheckPlayerThreshold()
+{
+	if (GetMatchState() == MatchState::WaitingToStart && NumPlayers >= PlayerNumberToStartGame)
+	{
+		SetMatchState(UT_MatchState::Countdown);
+	}
+	else if (GetMatchState() == UT_MatchState::Countdown && NumPlayers < PlayerNumberToStartGame)
+	{
+		SetMatchState(MatchState::WaitingToStart);
+	}
 }
 
+void AUT_DeathMatchGameMode::TravelToNextMap()
+{
+	const FString CurrentMap = UWorld::RemovePIEPrefix(GetWorld()->GetPackage()->GetName());
+
+	FString NextMap = CurrentMap;
+	if (MapRotation.Num() > 0)
+	{
+		const int32 CurrentIndex = MapRotation.IndexOfByPredicate([&CurrentMap](const TSoftObjectPtr<UWorld>& Map)
+		{
+			return Map.GetLongPackageName() == CurrentMap;
+		});
+		NextMap = MapRotation[(CurrentIndex + 1) % MapRotation.Num()].GetLongPackageName();
+	}
+
+	// Seamless, clients keep their connection through the transition map
+	GetWorld()->ServerTravel(NextMap, false);
+}
+
+int32 AUT_DeathMatchGameMode::ChooseTeam(AUT_PlayerState* PlayerState) const
+{
+	UT_SCOPE_STAT(ChooseTeam);
+
+	// return the index of the team least populated
+	if (AUT_DeathMatchGameState* DeathMatchGameState = GetGameState<AUT_DeathMatchGameState>())
+	{
+		return DeathMatchGameState->GetSmallestTeam();
+	}
+	return 0;
+}
@@ -2,15 +2,184 @@
 
 #include "UnrealTest/Game/UT_DeathMatchGameState.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+
+#include "UnrealTest/Character/UT_PlayerState.h"
+#include "UnrealTest/Net/UT_PushModel.h"
+
+const FName UT_MatchState::Countdown = FName(TEXT("Countdown"));
 
 AUT_DeathMatchGameState::AUT_DeathMatchGameState()
 {
 	NumTeams = 2;
+	MatchStateEndTime = 0.f;
+	TeamPlayerCounts.Init(0, NumTeams);
+	TeamScores.Init(0, NumTeams);
+	Scoreboard.Owner = this;
 }
 
 void AUT_DeathMatchGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AUT_DeathMatchGameState, NumTeams);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUT_DeathMatchGameState, NumTeams, FUT_PushModel::MakeParams());
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUT_DeathMatchGameState, MatchStateEndTime, FUT_PushModel::MakeParams());
+	DOREPLIFETIME_WITH_PARAMS_FAST(AUT_DeathMatchGameState, TeamScores, FUT_PushModel::MakeParams());
+
+	// Fast arrays track their dirty rows themselves
+	DOREPLIFETIME(AUT_DeathMatchGameState, Scoreboard);
+}
+
+void AUT_DeathMatchGameState::SetNumTeams(int32 NewNumTeams)
+{
+	NumTeams = FMath::Max(NewNumTeams, 1);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUT_DeathMatchGameState, NumTeams, this);
+	TeamPlayerCounts.Init(0, NumTeams);
+
+	TeamScores.Init(0, NumTeams);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUT_DeathMatchGameState, TeamScores, this);
+}
+
+void AUT_DeathMatchGameState::UpdateTeamCount(int32 OldTeam, int32 NewTeam)
+{
+	if (TeamPlayerCounts.IsValidIndex(OldTeam))
+	{
+		TeamPlayerCounts[OldTeam] = FMath::Max(TeamPlayerCounts[OldTeam] - 1, 0);
+	}
+	if (TeamPlayerCounts.IsValidIndex(NewTeam))
+	{
+		TeamPlayerCounts[NewTeam]++;
+	}
+}
+
+int32 AUT_DeathMatchGameState::GetTeamPlayerCount(int32 Team) const
+{
+	return TeamPlayerCounts.IsValidIndex(Team) ? TeamPlayerCounts[Team] : 0;
+}
+
+int32 AUT_DeathMatchGameState::GetSmallestTeam() const
+{
+	int32 SmallestTeam = 0;
+	for (int32 Team = 1; Team < TeamPlayerCounts.Num(); Team++)
+	{
+		if (TeamPlayerCounts[Team] < TeamPlayerCounts[SmallestTeam])
+		{
+			SmallestTeam = Team;
+		}
+	}
+	return SmallestTeam;
+}
+
+bool AUT_DeathMatchGameState::HasMatchStarted() const
+{
+	return GetMatchState() != UT_MatchState::Countdown && Super::HasMatchStarted();
+}
+
+void AUT_DeathMatchGameState::SetMatchStateEndTime(float NewMatchStateEndTime)
+{
+	MatchStateEndTime = NewMatchStateEndTime;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUT_DeathMatchGameState, MatchStateEndTime, this);
+}
+
+float AUT_DeathMatchGameState::GetMatchStateTimeRemaining() const
+{
+	return MatchStateEndTime > 0.f ? FMath::Max(MatchStateEndTime - GetServerWorldTimeSeconds(), 0.f) : 0.f;
+}
+
+void AUT_DeathMatchGameState::OnRep_MatchState()
+{
+	Super::OnRep_MatchState();
+
+	// Also called on the server by SetMatchState
+	OnMatchStateChanged.Broadcast(GetMatchState());
+}
+
+void AUT_DeathMatchGameState::AddPlayerState(APlayerState* PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+
+	if (HasAuthority())
+	{
+		Scoreboard.AddPlayer(PlayerState);
+		OnScoreboardChanged.Broadcast(PlayerState);
+	}
+}
+
+void AUT_DeathMatchGameState::RemovePlayerState(APlayerState* PlayerState)
+{
+	if (HasAuthority())
+	{
+		Scoreboard.RemovePlayer(PlayerState);
+		OnScoreboardChanged.Broadcast(PlayerState);
+	}
+
+	Super::RemovePlayerState(PlayerState);
+}
+
+void AUT_DeathMatchGameState::ScoreKill(APlayerState* Killer, APlayerState* Victim)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	Scoreboard.AddStats(Victim, 0, 1, 0);
+	OnScoreboardChanged.Broadcast(Victim);
+
+	// Suicides and team kills only count the death
+	const AUT_PlayerState* UTKiller = Cast<AUT_PlayerState>(Killer);
+	const AUT_PlayerState* UTVictim = Cast<AUT_PlayerState>(Victim);
+	if (!UTKiller || Killer == Victim || (UTVictim && UTKiller->GetTeamNum() == UTVictim->GetTeamNum()))
+	{
+		return;
+	}
+
+	Scoreboard.AddStats(Killer, 1, 0, KILL_SCORE);
+	OnScoreboardChanged.Broadcast(Killer);
+
+	if (TeamScores.IsValidIndex(UTKiller->GetTeamNum()))
+	{
+		TeamScores[UTKiller->GetTeamNum()] += KILL_SCORE;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AUT_DeathMatchGameState, TeamScores, this);
+		OnTeamScoresChanged.Broadcast();
+	}
+}
+
+void AUT_DeathMatchGameState::ResetScores()
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	Scoreboard.ResetStats();
+	OnScoreboardChanged.Broadcast(nullptr);
+
+	TeamScores.Init(0, NumTeams);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AUT_DeathMatchGameState, TeamScores, this);
+	OnTeamScoresChanged.Broadcast();
+}
+
+const TArray<FUT_ScoreboardEntry>& AUT_DeathMatchGameState::GetScoreboardEntries() const
+{
+	return Scoreboard.GetEntries();
+}
+
+bool AUT_DeathMatchGameState::GetPlayerScore(const APlayerState* PlayerState, int32& OutKills, int32& OutDeaths, int32& OutScore) const
+{
+	const FUT_ScoreboardEntry* Entry = Scoreboard.FindEntry(PlayerState);
+	OutKills = Entry ? Entry->Kills : 0;
+	OutDeaths = Entry ? Entry->Deaths : 0;
+	OutScore = Entry ? Entry->Score : 0;
+	return Entry != nullptr;
+}
+
+int32 AUT_DeathMatchGameState::GetTeamScore(int32 Team) const
+{
+	return TeamScores.IsValidIndex(Team) ? TeamScores[Team] : 0;
+}
+
+void AUT_DeathMatchGameState::OnRep_TeamScores()
+{
+	OnTeamScoresChanged.Broadcast();
 }
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_GameplayAssets.h"
+
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+
+const FPrimaryAssetType UUT_GameplayAssets::PRIMARY_ASSET_TYPE = TEXT("UT_GameplayAssets");
+const FName UUT_GameplayAssets::GAMEPLAY_BUNDLE = TEXT("Gameplay");
+const FName UUT_GameplayAssets::COSMETIC_BUNDLE = TEXT("Cosmetic");
+
+UUT_GameplayAssets::UUT_GameplayAssets()
+{
+	// Paths only, nothing is loaded with the class
+	DoorMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Game/StarterContent/Props/SM_Door.SM_Door")));
+
+	// Red and blue instances of both mannequin slots
+	TeamMaterials.SetNum(2);
+	TeamMaterials[0].Materials = {
+		TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Materials/MI_Manny_01_RedInstance.MI_Manny_01_RedInstance"))),
+		TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Materials/MI_Manny_02_RedInstance.MI_Manny_02_RedInstance")))
+	};
+	TeamMaterials[1].Materials = {
+		TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Materials/MI_Manny_01_BlueInstance.MI_Manny_01_BlueInstance"))),
+		TSoftObjectPtr<UMaterialInterface>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Materials/MI_Manny_02_BlueInstance.MI_Manny_02_BlueInstance")))
+	};
+}
+
+FPrimaryAssetId UUT_GameplayAssets::GetPrimaryAssetId() const
+{
+	return FPrimaryAssetId(PRIMARY_ASSET_TYPE, GetFName());
+}
+
+void UUT_GameplayAssets::GetBundlePaths(const TArray<FName>& Bundles, TArray<FSoftObjectPath>& OutPaths) const
+{
+	if (Bundles.Contains(GAMEPLAY_BUNDLE) && !DoorMesh.IsNull())
+	{
+		OutPaths.Add(DoorMesh.ToSoftObjectPath());
+	}
+
+	if (Bundles.Contains(COSMETIC_BUNDLE))
+	{
+		for (const FUT_TeamMaterials& Team : TeamMaterials)
+		{
+			for (const TSoftObjectPtr<UMaterialInterface>& Material : Team.Materials)
+			{
+				if (!Material.IsNull())
+				{
+					OutPaths.Add(Material.ToSoftObjectPath());
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_GameplayAssetsSubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
+
+#include "UnrealTest/Game/UT_GameplayAssets.h"
+
+void UUT_GameplayAssetsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Dedicated servers never render, cosmetic assets are left on disk
+	TArray<FName> Bundles = { UUT_GameplayAssets::GAMEPLAY_BUNDLE };
+	if (!IsRunningDedicatedServer())
+	{
+		Bundles.Add(UUT_GameplayAssets::COSMETIC_BUNDLE);
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+	TArray<FPrimaryAssetId> AssetIds;
+	AssetManager.GetPrimaryAssetIdList(UUT_GameplayAssets::PRIMARY_ASSET_TYPE, AssetIds);
+
+	if (AssetIds.Num() > 0)
+	{
+		GameplayAssetsId = AssetIds[0];
+		LoadHandle = AssetManager.LoadPrimaryAsset(GameplayAssetsId, Bundles);
+	}
+	else
+	{
+		TArray<FSoftObjectPath> Paths;
+		GetDefault<UUT_GameplayAssets>()->GetBundlePaths(Bundles, Paths);
+		LoadHandle = AssetManager.GetStreamableManager().RequestAsyncLoad(Paths);
+	}
+}
+
+void UUT_GameplayAssetsSubsystem::Deinitialize()
+{
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->ReleaseHandle();
+		LoadHandle.Reset();
+	}
+
+	if (GameplayAssetsId.IsValid() && UAssetManager::IsValid())
+	{
+		UAssetManager::Get().UnloadPrimaryAsset(GameplayAssetsId);
+	}
+
+	Super::Deinitialize();
+}
+
+const UUT_GameplayAssets* UUT_GameplayAssetsSubsystem::GetGameplayAssets() const
+{
+	if (GameplayAssetsId.IsValid())
+	{
+		if (const UUT_GameplayAssets* GameplayAssets = UAssetManager::Get().GetPrimaryAssetObject<UUT_GameplayAssets>(GameplayAssetsId))
+		{
+			return GameplayAssets;
+		}
+	}
+	return GetDefault<UUT_GameplayAssets>();
+}
+
+const UUT_GameplayAssets* UUT_GameplayAssetsSubsystem::FindGameplayAssets(const UWorld* World)
+{
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	if (const UUT_GameplayAssetsSubsystem* GameplayAssetsSubsystem = GameInstance ? GameInstance->GetSubsystem<UUT_GameplayAssetsSubsystem>() : nullptr)
+	{
+		return GameplayAssetsSubsystem->GetGameplayAssets();
+	}
+	return GetDefault<UUT_GameplayAssets>();
+}
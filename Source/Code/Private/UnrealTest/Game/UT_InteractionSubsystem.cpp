@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_InteractionSubsystem.h"
+
+#include "UnrealTest/Items/Door.h"
+
+void UUT_InteractionSubsystem::RegisterDoor(ADoor* Door)
+{
+	if (Door)
+	{
+		Cells.FindOrAdd(GetCell(Door->GetActorLocation())).Doors.AddUnique(Door);
+	}
+}
+
+void UUT_InteractionSubsystem::UnregisterDoor(ADoor* Door)
+{
+	const FIntPoint Cell = GetCell(Door->GetActorLocation());
+	if (FUT_InteractionCell* InteractionCell = Cells.Find(Cell))
+	{
+		InteractionCell->Doors.RemoveSwap(Door);
+		if (InteractionCell->Doors.Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+ADoor* UUT_InteractionSubsystem::FindBestDoor(const FVector& Location, const FVector& Facing) const
+{
+	const FVector Facing2D = Facing.GetSafeNormal2D();
+	const FIntPoint MinCell = GetCell(Location - FVector(INTERACTION_DISTANCE));
+	const FIntPoint MaxCell = GetCell(Location + FVector(INTERACTION_DISTANCE));
+
+	ADoor* BestDoor = nullptr;
+	float BestDistSquared = FMath::Square(INTERACTION_DISTANCE);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+		{
+			const FUT_InteractionCell* InteractionCell = Cells.Find(FIntPoint(X, Y));
+			if (!InteractionCell)
+			{
+				continue;
+			}
+
+			for (ADoor* Door : InteractionCell->Doors)
+			{
+				const FVector ToDoor = Door->GetActorLocation() - Location;
+				const float DistSquared = ToDoor.SizeSquared();
+				if (DistSquared > BestDistSquared)
+				{
+					continue;
+				}
+
+				// Only doors in front of the pawn
+				if (FVector::DotProduct(ToDoor.GetSafeNormal2D(), Facing2D) < MIN_FACING_DOT)
+				{
+					continue;
+				}
+
+				BestDoor = Door;
+				BestDistSquared = DistSquared;
+			}
+		}
+	}
+
+	return BestDoor;
+}
+
+FIntPoint UUT_InteractionSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt(Location.X / CELL_SIZE), FMath::FloorToInt(Location.Y / CELL_SIZE));
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_Scoreboard.h"
+
+#include "GameFramework/PlayerState.h"
+
+#include "UnrealTest/Game/UT_DeathMatchGameState.h"
+
+void FUT_ScoreboardEntry::PostReplicatedAdd(const FUT_Scoreboard& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnScoreboardChanged.Broadcast(PlayerState);
+	}
+}
+
+void FUT_ScoreboardEntry::PostReplicatedChange(const FUT_Scoreboard& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnScoreboardChanged.Broadcast(PlayerState);
+	}
+}
+
+void FUT_ScoreboardEntry::PreReplicatedRemove(const FUT_Scoreboard& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->OnScoreboardChanged.Broadcast(PlayerState);
+	}
+}
+
+void FUT_Scoreboard::AddPlayer(APlayerState* PlayerState)
+{
+	if (!PlayerState || FindEntry(PlayerState))
+	{
+		return;
+	}
+
+	FUT_ScoreboardEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.PlayerState = PlayerState;
+	MarkItemDirty(Entry);
+}
+
+void FUT_Scoreboard::RemovePlayer(const APlayerState* PlayerState)
+{
+	const int32 Index = Entries.IndexOfByPredicate([PlayerState](const FUT_ScoreboardEntry& Entry) { return Entry.PlayerState == PlayerState; });
+	if (Index != INDEX_NONE)
+	{
+		// Order does not matter, clients sort for display
+		Entries.RemoveAtSwap(Index, 1, false);
+		MarkArrayDirty();
+	}
+}
+
+void FUT_Scoreboard::AddStats(const APlayerState* PlayerState, int32 Kills, int32 Deaths, int32 Score)
+{
+	FUT_ScoreboardEntry* Entry = Entries.FindByPredicate([PlayerState](const FUT_ScoreboardEntry& Item) { return Item.PlayerState == PlayerState; });
+	if (!Entry)
+	{
+		return;
+	}
+
+	Entry->Kills += Kills;
+	Entry->Deaths += Deaths;
+	Entry->Score += Score;
+	MarkItemDirty(*Entry);
+}
+
+void FUT_Scoreboard::ResetStats()
+{
+	for (FUT_ScoreboardEntry& Entry : Entries)
+	{
+		Entry.Kills = 0;
+		Entry.Deaths = 0;
+		Entry.Score = 0;
+		MarkItemDirty(Entry);
+	}
+}
+
+const FUT_ScoreboardEntry* FUT_Scoreboard::FindEntry(const APlayerState* PlayerState) const
+{
+	return Entries.FindByPredicate([PlayerState](const FUT_ScoreboardEntry& Entry) { return Entry.PlayerState == PlayerState; });
+}
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Game/UT_SpawnPointSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Character/UT_PlayerState.h"
+#include "UnrealTest/Components/UT_CustomPlayerStart.h"
+
+void UUT_SpawnPointSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Only the server spawns players
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (TPair<int32, FUT_SpawnTeamBucket>& Pair : TeamBuckets)
+	{
+		FUT_SpawnTeamBucket& Bucket = Pair.Value;
+		if (Bucket.bTracesInFlight)
+		{
+			RankStarts(Bucket);
+		}
+		else if (Bucket.Starts.Num() > 0 && Now - Bucket.RankingTime >= RANKING_LIFETIME)
+		{
+			IssueTraces(Pair.Key, Bucket);
+		}
+	}
+}
+
+TStatId UUT_SpawnPointSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_SpawnPointSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_SpawnPointSubsystem::RegisterStart(AUT_CustomPlayerStart* PlayerStart)
+{
+	if (!PlayerStart)
+	{
+		return;
+	}
+
+	FUT_SpawnTeamBucket& Bucket = TeamBuckets.FindOrAdd(PlayerStart->GetSpawnTeam());
+	if (!Bucket.Starts.Contains(PlayerStart))
+	{
+		Bucket.Starts.Add(PlayerStart);
+		// Never used yet
+		Bucket.LastUsedTimes.Add(-RECENT_USE_WINDOW);
+		ResetRanking(Bucket);
+	}
+}
+
+void UUT_SpawnPointSubsystem::UnregisterStart(AUT_CustomPlayerStart* PlayerStart)
+{
+	if (FUT_SpawnTeamBucket* Bucket = TeamBuckets.Find(PlayerStart->GetSpawnTeam()))
+	{
+		const int32 Index = Bucket->Starts.Find(PlayerStart);
+		if (Index != INDEX_NONE)
+		{
+			Bucket->Starts.RemoveAtSwap(Index);
+			Bucket->LastUsedTimes.RemoveAtSwap(Index);
+			ResetRanking(*Bucket);
+		}
+	}
+}
+
+AUT_CustomPlayerStart* UUT_SpawnPointSubsystem::ClaimStart(int32 TeamNum)
+{
+	FUT_SpawnTeamBucket* Bucket = TeamBuckets.Find(TeamNum);
+	if (!Bucket || Bucket->Starts.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const int32 NumStarts = Bucket->Starts.Num();
+
+	// Safest start that was not used recently
+	for (const int32 Index : Bucket->Ranking)
+	{
+		if (Now - Bucket->LastUsedTimes[Index] >= RECENT_USE_WINDOW)
+		{
+			Bucket->LastUsedTimes[Index] = Now;
+			return Bucket->Starts[Index];
+		}
+	}
+
+	// Not ranked yet or all blocked, probe from a random offset, keep the least recently used one in case all are blocked
+	const int32 Offset = FMath::RandHelper(NumStarts);
+	int32 BestIndex = Offset;
+	for (int32 i = 0; i < NumStarts; i++)
+	{
+		const int32 Index = (Offset + i) % NumStarts;
+		if (Now - Bucket->LastUsedTimes[Index] >= RECENT_USE_WINDOW)
+		{
+			BestIndex = Index;
+			break;
+		}
+		if (Bucket->LastUsedTimes[Index] < Bucket->LastUsedTimes[BestIndex])
+		{
+			BestIndex = Index;
+		}
+	}
+
+	Bucket->LastUsedTimes[BestIndex] = Now;
+	return Bucket->Starts[BestIndex];
+}
+
+const TArray<AUT_CustomPlayerStart*>& UUT_SpawnPointSubsystem::GetTeamStarts(int32 TeamNum) const
+{
+	static const TArray<AUT_CustomPlayerStart*> EmptyStarts;
+
+	const FUT_SpawnTeamBucket* Bucket = TeamBuckets.Find(TeamNum);
+	return Bucket ? Bucket->Starts : EmptyStarts;
+}
+
+void UUT_SpawnPointSubsystem::IssueTraces(int32 TeamNum, FUT_SpawnTeamBucket& Bucket) const
+{
+	UWorld* World = GetWorld();
+
+	Bucket.StartLocations.Reset(Bucket.Starts.Num());
+	for (const AUT_CustomPlayerStart* Start : Bucket.Starts)
+	{
+		Bucket.StartLocations.Add(Start ? Start->GetActorLocation() + EYE_OFFSET : FVector::ZeroVector);
+	}
+
+	// Traces are batched with the rest of the frame and run off the game thread
+	Bucket.EnemyLocations.Reset();
+	Bucket.PendingTraces.Reset();
+	if (const AGameStateBase* GameState = World->GetGameState())
+	{
+		for (const APlayerState* PlayerState : GameState->PlayerArray)
+		{
+			const AUT_PlayerState* UTPlayerState = Cast<AUT_PlayerState>(PlayerState);
+			APawn* Pawn = UTPlayerState ? UTPlayerState->GetPawn() : nullptr;
+			if (!Pawn || UTPlayerState->GetTeamNum() == TeamNum)
+			{
+				continue;
+			}
+
+			const FVector EyeLocation = Pawn->GetPawnViewLocation();
+			Bucket.EnemyLocations.Add(EyeLocation);
+
+			const FCollisionQueryParams Params(SCENE_QUERY_STAT(UT_SpawnVisibility), false, Pawn);
+			for (int32 i = 0; i < Bucket.StartLocations.Num(); i++)
+			{
+				if (FVector::DistSquared(EyeLocation, Bucket.StartLocations[i]) > FMath::Square(MAX_VISIBILITY_DISTANCE))
+				{
+					continue;
+				}
+
+				FUT_SpawnTrace& Trace = Bucket.PendingTraces.AddDefaulted_GetRef();
+				Trace.StartIndex = i;
+				Trace.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, EyeLocation, Bucket.StartLocations[i], ECC_Visibility, Params);
+			}
+		}
+	}
+
+	Bucket.bTracesInFlight = true;
+}
+
+void UUT_SpawnPointSubsystem::RankStarts(FUT_SpawnTeamBucket& Bucket) const
+{
+	UT_SCOPE_STAT(SpawnScoring);
+
+	Bucket.bTracesInFlight = false;
+
+	const int32 NumStarts = Bucket.StartLocations.Num();
+	TArray<int32> VisibleEnemies;
+	VisibleEnemies.SetNumZeroed(NumStarts);
+
+	FTraceDatum TraceData;
+	for (const FUT_SpawnTrace& Trace : Bucket.PendingTraces)
+	{
+		// Results only live for a frame, score again on the next tick
+		if (!GetWorld()->QueryTraceData(Trace.Handle, TraceData))
+		{
+			Bucket.PendingTraces.Reset();
+			return;
+		}
+
+		if (!FHitResult::GetFirstBlockingHit(TraceData.OutHits))
+		{
+			VisibleEnemies[Trace.StartIndex]++;
+		}
+	}
+	Bucket.PendingTraces.Reset();
+
+	// Closest enemy distance minus a penalty per enemy seeing the start
+	TArray<float> Scores;
+	Scores.SetNumUninitialized(NumStarts);
+	const TArray<FVector>& StartLocations = Bucket.StartLocations;
+	const TArray<FVector>& EnemyLocations = Bucket.EnemyLocations;
+	ParallelFor(NumStarts, [&](int32 Index)
+	{
+		float ClosestDistanceSquared = FMath::Square(SAFE_DISTANCE);
+		for (const FVector& EnemyLocation : EnemyLocations)
+		{
+			ClosestDistanceSquared = FMath::Min<float>(ClosestDistanceSquared, FVector::DistSquared(EnemyLocation, StartLocations[Index]));
+		}
+		Scores[Index] = FMath::Sqrt(ClosestDistanceSquared) - VISIBLE_ENEMY_PENALTY * VisibleEnemies[Index];
+	});
+
+	Bucket.Ranking.SetNumUninitialized(NumStarts);
+	for (int32 i = 0; i < NumStarts; i++)
+	{
+		Bucket.Ranking[i] = i;
+	}
+	Bucket.Ranking.Sort([&Scores](int32 A, int32 B) { return Scores[A] > Scores[B]; });
+
+	Bucket.RankingTime = GetWorld()->GetTimeSeconds();
+}
+
+void UUT_SpawnPointSubsystem::ResetRanking(FUT_SpawnTeamBucket& Bucket)
+{
+	Bucket.Ranking.Reset();
+	Bucket.RankingTime = -1.f;
+	Bucket.PendingTraces.Reset();
+	Bucket.bTracesInFlight = false;
+}
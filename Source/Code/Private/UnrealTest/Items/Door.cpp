@@ -3,141 +3,281 @@
 
 #include "UnrealTest/Items/Door.h"
 
+#include "DrawDebugHelpers.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "TimerManager.h"
+#include "UObject/ObjectSaveContext.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Game/UT_GameplayAssets.h"
+#include "UnrealTest/Game/UT_GameplayAssetsSubsystem.h"
+#include "UnrealTest/Game/UT_InteractionSubsystem.h"
+#include "UnrealTest/Items/UT_DoorAnimationSubsystem.h"
+#include "UnrealTest/Items/UT_DoorInstanceSubsystem.h"
+#include "UnrealTest/Net/UT_NetDormancySubsystem.h"
+#include "UnrealTest/Net/UT_NetTime.h"
+#include "UnrealTest/Net/UT_PushModel.h"
+
+float FDoorState::GetElapsedTime(float ServerTime) const
+{
+	return FUT_NetTime::GetElapsed(ToggleTime, ServerTime);
+}
+
+bool FDoorState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	uint8 Flags = (bIsOpen ? 1 : 0) | (Direction < 0 ? 2 : 0) | (bSettled ? 4 : 0);
+	Ar.SerializeBits(&Flags, 3);
+	Ar << ToggleTime;
+
+	if (Ar.IsLoading())
+	{
+		bIsOpen = (Flags & 1) != 0;
+		Direction = (Flags & 2) ? -1 : 1;
+		bSettled = (Flags & 4) != 0;
+	}
+
+	bOutSuccess = true;
+	return true;
+}
 
 // Sets default values
 ADoor::ADoor()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Doors are animated in batch by UUT_DoorAnimationSubsystem
+	PrimaryActorTick.bCanEverTick = false;
 	
 	BoxComponent = CreateDefaultSubobject<UBoxComponent>(TEXT("Box Component"));
 	BoxComponent->InitBoxExtent(FVector(150, 100, 100));
 	BoxComponent->SetCollisionProfileName("Trigger");
+	// Pawns find doors through UUT_InteractionSubsystem
+	BoxComponent->SetGenerateOverlapEvents(false);
 	RootComponent = BoxComponent;
 	
+	// Mesh is a soft reference set on BeginPlay in game and on construction in the editor, see UUT_GameplayAssets
 	DoorMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh Component"));
 	DoorMesh->SetupAttachment(RootComponent);
-	
-	static ConstructorHelpers::FObjectFinder<UStaticMesh> DoorAsset(TEXT("/Game/StarterContent/Props/SM_Door.SM_Door"));
-	if (DoorAsset.Succeeded())
-	{
-		DoorMesh->SetStaticMesh(DoorAsset.Object);
-		DoorMesh->SetRelativeLocation(FVector(0.f, 50.f, -100.0f));
-		DoorMesh->SetWorldScale3D(FVector(1.f));
-	}
-
-	bIsDoorOpened = false;
-	bIsDoorOpening = false;
-	bIsDoorClosing = false;
+	DoorMesh->SetRelativeLocation(FVector(0.f, 50.f, -100.0f));
+	DoorMesh->SetWorldScale3D(FVector(1.f));
 
-	DotProduct = 0.f;
-	MaxDegree = 0.f;
-	PositiveNegative = 0.f;
-	DoorCurrentRotation = 0.f;
+	bUseInstancedMesh = false;
+	DoorInstances = nullptr;
+	DoorInstanceIndex = INDEX_NONE;
 
 	bReplicates = true;
+	// Only woken while toggling, see UUT_NetDormancySubsystem
+	NetDormancy = DORM_Initial;
 }
 
-// Called when the game starts or when spawned
-void ADoor::BeginPlay()
+void ADoor::OnConstruction(const FTransform& Transform)
 {
-	Super::BeginPlay();
+	Super::OnConstruction(Transform);
 
-	DrawDebugBox(GetWorld(), GetActorLocation(), BoxComponent->GetScaledBoxExtent(), FQuat(GetActorRotation()), FColor::Turquoise, true, -1, 0, 2);
+	// Editor worlds never begin play, the mesh is needed to place and collide with the door
+	// Blueprints may have set their own mesh
+	if (DoorMesh && !DoorMesh->GetStaticMesh() && !GetWorld()->IsGameWorld())
+	{
+		const TSoftObjectPtr<UStaticMesh> MeshAsset = GetDoorMeshAsset();
+		DoorMesh->SetStaticMesh(MeshAsset.LoadSynchronous());
+	}
 }
 
-void ADoor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+#if WITH_EDITOR
+void ADoor::PreSave(FObjectPreSaveContext ObjectSaveContext)
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	Super::PreSave(ObjectSaveContext);
 
-	DOREPLIFETIME(ADoor, bIsDoorOpened);
-	DOREPLIFETIME(ADoor, bIsDoorOpening);
-	DOREPLIFETIME(ADoor, bIsDoorClosing);
-	DOREPLIFETIME(ADoor, DotProduct);
-	DOREPLIFETIME(ADoor, MaxDegree);
-	DOREPLIFETIME(ADoor, AddRotation);
-	DOREPLIFETIME(ADoor, PositiveNegative);
-	DOREPLIFETIME(ADoor, DoorCurrentRotation);
-	DOREPLIFETIME(ADoor, DoorForwardVector);
+	// Cooked maps keep the soft reference only, the editor mesh would be a hard one
+	if (ObjectSaveContext.IsCooking() && DoorMesh && DoorMesh->GetStaticMesh() == GetDoorMeshAsset().Get())
+	{
+		DoorMesh->SetStaticMesh(nullptr);
+	}
 }
+#endif
 
-void ADoor::OnRep_DoorToggled()
+// Called when the game starts or when spawned
+void ADoor::BeginPlay()
 {
-	DotProduct = FVector::DotProduct(BoxComponent->GetForwardVector(), DoorForwardVector);
-	PositiveNegative = FMath::Sign(DotProduct);
+	Super::BeginPlay();
+
+#if !UE_SERVER
+	// Outline of the trigger, nobody sees it on a dedicated server
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		DrawDebugBox(GetWorld(), GetActorLocation(), BoxComponent->GetScaledBoxExtent(), FQuat(GetActorRotation()), FColor::Turquoise, true, -1, 0, 2);
+	}
+#endif
 
-	MaxDegree = PositiveNegative * 90.f;
+	if (UUT_InteractionSubsystem* Interaction = GetWorld()->GetSubsystem<UUT_InteractionSubsystem>())
+	{
+		Interaction->RegisterDoor(this);
+	}
 
-	if (bIsDoorOpened)
+	// Usually preloaded by UUT_GameplayAssetsSubsystem while the map loaded
+	const TSoftObjectPtr<UStaticMesh> MeshAsset = GetDoorMeshAsset();
+	if (DoorMesh && !DoorMesh->GetStaticMesh() && MeshAsset.IsPending())
 	{
-		bIsDoorOpening = false;
-		bIsDoorClosing = true;
-		CloseDoor(1.0f);
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(MeshAsset.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &ADoor::OnDoorMeshLoaded, MeshAsset));
 	}
 	else
 	{
-		bIsDoorClosing = false;
-		bIsDoorOpening = true;
-		OpenDoor(1.0f);
+		OnDoorMeshLoaded(MeshAsset);
 	}
 }
 
-// Called every frame
-void ADoor::Tick(float DeltaTime)
+TSoftObjectPtr<UStaticMesh> ADoor::GetDoorMeshAsset() const
 {
-	Super::Tick(DeltaTime);
+	return DoorMeshAsset.IsNull() ? UUT_GameplayAssetsSubsystem::FindGameplayAssets(GetWorld())->DoorMesh : DoorMeshAsset;
 }
 
-void ADoor::OpenDoor(const float DeltaTime)
+void ADoor::OnDoorMeshLoaded(TSoftObjectPtr<UStaticMesh> MeshAsset)
 {
-	DoorCurrentRotation = DoorMesh->GetRelativeRotation().Yaw;
-
-	AddRotation = PositiveNegative * DeltaTime * 80;
+	if (!DoorMesh || IsActorBeingDestroyed())
+	{
+		return;
+	}
 
-	if (FMath::IsNearlyEqual(DoorCurrentRotation, MaxDegree, 1.5f))
+	// Blueprints may have set their own mesh
+	if (!DoorMesh->GetStaticMesh())
 	{
-		bIsDoorOpening = false;
-		bIsDoorClosing = false;
+		DoorMesh->SetStaticMesh(MeshAsset.Get());
 	}
-	else if(bIsDoorOpening)
+
+	if (bUseInstancedMesh && DoorMesh->GetStaticMesh())
 	{
-		const FRotator NewRotation = FRotator(0.f, AddRotation, 0.f);
-		DoorMesh->AddRelativeRotation(FQuat(NewRotation), false, 0, ETeleportType::None);
+		if (UUT_DoorInstanceSubsystem* DoorInstanceSubsystem = GetWorld()->GetSubsystem<UUT_DoorInstanceSubsystem>())
+		{
+			DoorMeshRestTransform = FTransform(FQuat::Identity, DoorMesh->GetRelativeLocation(), DoorMesh->GetRelativeScale3D());
+			const FTransform InstanceTransform = GetDoorInstanceTransform(DoorMesh->GetRelativeRotation().Yaw);
+			DoorInstanceIndex = DoorInstanceSubsystem->AddDoorInstance(DoorMesh->GetStaticMesh(), InstanceTransform, DoorInstances);
+
+			// The field renders and collides for us from now on
+			if (DoorInstanceIndex != INDEX_NONE)
+			{
+				DoorMesh->DestroyComponent();
+				DoorMesh = nullptr;
+
+				// State may have been received before BeginPlay
+				if (!(DoorState == FDoorState()))
+				{
+					OnRep_DoorState();
+				}
+			}
+		}
 	}
 }
 
-void ADoor::CloseDoor(const float DeltaTime)
+void ADoor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
-	DoorCurrentRotation = DoorMesh->GetRelativeRotation().Yaw;
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_WITH_PARAMS_FAST(ADoor, DoorState, FUT_PushModel::MakeParams());
+}
 
-	if (DoorCurrentRotation > 0)
+void ADoor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UUT_InteractionSubsystem* Interaction = GetWorld()->GetSubsystem<UUT_InteractionSubsystem>())
 	{
-		AddRotation = -(DeltaTime * 80);	
+		Interaction->UnregisterDoor(this);
 	}
-	else
+
+	if (UUT_DoorAnimationSubsystem* DoorAnimation = GetWorld()->GetSubsystem<UUT_DoorAnimationSubsystem>())
 	{
-		AddRotation = DeltaTime * 80;
+		DoorAnimation->RemoveMovingDoor(this);
 	}
 
-	if (FMath::IsNearlyEqual(DoorCurrentRotation, 0.f, 1.5f))
+	if (UUT_DoorInstanceSubsystem* DoorInstanceSubsystem = GetWorld()->GetSubsystem<UUT_DoorInstanceSubsystem>())
 	{
-		bIsDoorClosing = false;
-		bIsDoorOpening = false;
+		DoorInstanceSubsystem->RemoveDoorInstance(DoorInstances, DoorInstanceIndex);
+		DoorInstances = nullptr;
+		DoorInstanceIndex = INDEX_NONE;
 	}
-	else if (bIsDoorClosing)
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADoor::OnRep_DoorState()
+{
+	if (UUT_DoorAnimationSubsystem* DoorAnimation = GetWorld()->GetSubsystem<UUT_DoorAnimationSubsystem>())
 	{
-		const FRotator NewRotation = FRotator(0.f, AddRotation, 0.f);
-		DoorMesh->AddRelativeRotation(FQuat(NewRotation), false, 0, ETeleportType::None);
+		DoorAnimation->AddMovingDoor(this, DoorState);
 	}
 }
 
+float ADoor::GetDoorYaw(const FDoorState& State, float ServerTime)
+{
+	if (State.bSettled)
+	{
+		return GetDoorRestYaw(State);
+	}
+
+	const float Travel = FMath::Min(State.GetElapsedTime(ServerTime) * ROTATION_SPEED, MAX_DEGREE);
+	const float Degree = State.bIsOpen ? Travel : MAX_DEGREE - Travel;
+	return State.Direction * Degree;
+}
+
+bool ADoor::IsDoorMoving(const FDoorState& State, float ServerTime)
+{
+	return !State.bSettled && State.GetElapsedTime(ServerTime) * ROTATION_SPEED < MAX_DEGREE;
+}
+
+float ADoor::GetDoorRestYaw(const FDoorState& State)
+{
+	return State.bIsOpen ? State.Direction * MAX_DEGREE : 0.f;
+}
+
+FTransform ADoor::GetDoorInstanceTransform(float Yaw) const
+{
+	const FTransform YawTransform(FRotator(0.f, Yaw, 0.f));
+	return YawTransform * DoorMeshRestTransform * GetActorTransform();
+}
+
 void ADoor::ToggleDoor(FVector ForwardVector)
 {
-	DoorForwardVector = ForwardVector;
 	if (HasAuthority())
 	{
-		bIsDoorOpened = !bIsDoorOpened;
-		OnRep_DoorToggled();
+		UT_SCOPE_STAT(DoorToggle);
+		INC_DWORD_STAT(STAT_UT_NumDoorToggles);
+
+		// Stay awake until the motion is over
+		if (UUT_NetDormancySubsystem* DormancySubsystem = GetWorld()->GetSubsystem<UUT_NetDormancySubsystem>())
+		{
+			DormancySubsystem->WakeActor(this, MAX_DEGREE / ROTATION_SPEED + SETTLE_MARGIN);
+		}
+
+		const float ServerTime = FUT_NetTime::GetServerTime(GetWorld());
+
+		// Doors at rest are not evaluated from the timestamp, it may have wrapped
+		UUT_DoorAnimationSubsystem* DoorAnimation = GetWorld()->GetSubsystem<UUT_DoorAnimationSubsystem>();
+		const bool bIsMoving = DoorAnimation && DoorAnimation->IsDoorMoving(this);
+		const float CurrentDegree = FMath::Abs(bIsMoving ? GetDoorYaw(DoorState, ServerTime) : GetDoorRestYaw(DoorState));
+
+		// Side is only picked when opening a closed door, closing goes back the same way
+		if (!DoorState.bIsOpen && FMath::IsNearlyZero(CurrentDegree, 1.5f))
+		{
+			const float DotProduct = FVector::DotProduct(BoxComponent->GetForwardVector(), ForwardVector);
+			DoorState.Direction = DotProduct < 0.f ? -1 : 1;
+		}
+
+		DoorState.bIsOpen = !DoorState.bIsOpen;
+		DoorState.bSettled = false;
+
+		// Backdate the toggle so a door reversed mid-motion continues from where it is
+		const float Travel = DoorState.bIsOpen ? CurrentDegree : MAX_DEGREE - CurrentDegree;
+		DoorState.ToggleTime = FUT_NetTime::Quantize(ServerTime - Travel / ROTATION_SPEED);
+		MARK_PROPERTY_DIRTY_FROM_NAME(ADoor, DoorState, this);
+		OnRep_DoorState();
+
+		// ToggleTime wraps every ~655 seconds, states received later must not look like a motion
+		GetWorldTimerManager().SetTimer(SettleTimer, this, &ADoor::SettleDoor, MAX_DEGREE / ROTATION_SPEED, false);
 	}
 }
+
+void ADoor::SettleDoor()
+{
+	DoorState.bSettled = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ADoor, DoorState, this);
+}
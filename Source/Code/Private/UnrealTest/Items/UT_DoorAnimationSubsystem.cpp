@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Items/UT_DoorAnimationSubsystem.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Net/UT_NetTime.h"
+
+void UUT_DoorAnimationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SET_DWORD_STAT(STAT_UT_NumMovingDoors, Doors.Num());
+	CSV_CUSTOM_STAT(UnrealTest, MovingDoors, Doors.Num(), ECsvCustomStatOp::Set);
+
+	if (Doors.Num() == 0 && DirtyDoorInstances.Num() == 0)
+	{
+		return;
+	}
+
+	UT_SCOPE_STAT(DoorAnimation);
+
+	const float ServerTime = FUT_NetTime::GetServerTime(GetWorld());
+
+	// Iterate backwards so finished doors can be swapped out
+	for (int32 i = Doors.Num() - 1; i >= 0; i--)
+	{
+		if (UpdateDoor(i, ServerTime))
+		{
+			RemoveAtSwap(i);
+		}
+	}
+
+	for (UHierarchicalInstancedStaticMeshComponent* Instances : DirtyDoorInstances)
+	{
+		if (IsValid(Instances))
+		{
+			Instances->MarkRenderStateDirty();
+		}
+	}
+	DirtyDoorInstances.Reset();
+}
+
+TStatId UUT_DoorAnimationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_DoorAnimationSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_DoorAnimationSubsystem::AddMovingDoor(ADoor* Door, const FDoorState& DoorState)
+{
+	if (!Door)
+	{
+		return;
+	}
+
+	int32 Index = Doors.Find(Door);
+	if (Index == INDEX_NONE)
+	{
+		Index = Doors.Add(Door);
+		DoorMeshes.AddDefaulted();
+		DoorInstances.AddDefaulted();
+		DoorInstanceIndices.AddDefaulted();
+		DoorStates.AddDefaulted();
+	}
+
+	// Door may have switched to the door field since it was added
+	DoorMeshes[Index] = Door->GetDoorMesh();
+	DoorInstances[Index] = Door->GetDoorInstances();
+	DoorInstanceIndices[Index] = Door->GetDoorInstanceIndex();
+	DoorStates[Index] = DoorState;
+
+	// Late joiners jump straight to the current point of the animation
+	if (UpdateDoor(Index, FUT_NetTime::GetServerTime(GetWorld())))
+	{
+		RemoveAtSwap(Index);
+	}
+}
+
+void UUT_DoorAnimationSubsystem::RemoveMovingDoor(ADoor* Door)
+{
+	const int32 Index = Doors.Find(Door);
+	if (Index != INDEX_NONE)
+	{
+		RemoveAtSwap(Index);
+	}
+}
+
+bool UUT_DoorAnimationSubsystem::IsDoorMoving(const ADoor* Door) const
+{
+	return Doors.Contains(Door);
+}
+
+bool UUT_DoorAnimationSubsystem::UpdateDoor(int32 Index, float ServerTime)
+{
+	const FDoorState& DoorState = DoorStates[Index];
+	const float Yaw = ADoor::GetDoorYaw(DoorState, ServerTime);
+
+	if (UStaticMeshComponent* DoorMesh = DoorMeshes[Index])
+	{
+		const FRotator NewRotation = FRotator(0.f, Yaw, 0.f);
+		DoorMesh->SetRelativeRotation(NewRotation, false, nullptr, ETeleportType::None);
+	}
+	else if (UHierarchicalInstancedStaticMeshComponent* Instances = DoorInstances[Index])
+	{
+		if (!IsValid(Instances) || !IsValid(Doors[Index]))
+		{
+			return true;
+		}
+		Instances->UpdateInstanceTransform(DoorInstanceIndices[Index], Doors[Index]->GetDoorInstanceTransform(Yaw), true, false, false);
+		DirtyDoorInstances.AddUnique(Instances);
+	}
+	else
+	{
+		return true;
+	}
+
+	return !ADoor::IsDoorMoving(DoorState, ServerTime);
+}
+
+void UUT_DoorAnimationSubsystem::RemoveAtSwap(int32 Index)
+{
+	Doors.RemoveAtSwap(Index, 1, false);
+	DoorMeshes.RemoveAtSwap(Index, 1, false);
+	DoorInstances.RemoveAtSwap(Index, 1, false);
+	DoorInstanceIndices.RemoveAtSwap(Index, 1, false);
+	DoorStates.RemoveAtSwap(Index, 1, false);
+}
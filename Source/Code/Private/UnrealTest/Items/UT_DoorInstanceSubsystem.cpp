@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Items/UT_DoorInstanceSubsystem.h"
+
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+int32 UUT_DoorInstanceSubsystem::AddDoorInstance(UStaticMesh* DoorMesh, const FTransform& WorldTransform, UHierarchicalInstancedStaticMeshComponent*& OutInstances)
+{
+	OutInstances = FindOrCreateField(DoorMesh);
+	if (!OutInstances)
+	{
+		return INDEX_NONE;
+	}
+
+	FUT_DoorInstanceField& Field = Fields.FindChecked(DoorMesh);
+	if (Field.FreeIndices.Num() > 0)
+	{
+		const int32 InstanceIndex = Field.FreeIndices.Pop(false);
+		OutInstances->UpdateInstanceTransform(InstanceIndex, WorldTransform, true, true, true);
+		return InstanceIndex;
+	}
+
+	return OutInstances->AddInstanceWorldSpace(WorldTransform);
+}
+
+void UUT_DoorInstanceSubsystem::RemoveDoorInstance(UHierarchicalInstancedStaticMeshComponent* Instances, int32 InstanceIndex)
+{
+	if (!IsValid(Instances) || InstanceIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (FUT_DoorInstanceField* Field = Fields.Find(Instances->GetStaticMesh()))
+	{
+		// Zero scale hides the instance and removes its collision
+		FTransform HiddenTransform;
+		Instances->GetInstanceTransform(InstanceIndex, HiddenTransform, true);
+		HiddenTransform.SetScale3D(FVector::ZeroVector);
+		Instances->UpdateInstanceTransform(InstanceIndex, HiddenTransform, true, true, true);
+
+		Field->FreeIndices.Add(InstanceIndex);
+	}
+}
+
+UHierarchicalInstancedStaticMeshComponent* UUT_DoorInstanceSubsystem::FindOrCreateField(UStaticMesh* DoorMesh)
+{
+	if (!DoorMesh)
+	{
+		return nullptr;
+	}
+
+	if (FUT_DoorInstanceField* Field = Fields.Find(DoorMesh))
+	{
+		return Field->Instances;
+	}
+
+	if (!FieldActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		FieldActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!FieldActor)
+		{
+			return nullptr;
+		}
+		FieldActor->SetRootComponent(NewObject<USceneComponent>(FieldActor, TEXT("Root")));
+		FieldActor->GetRootComponent()->RegisterComponent();
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(FieldActor);
+	Instances->SetStaticMesh(DoorMesh);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetCollisionProfileName(UCollisionProfile::BlockAllDynamic_ProfileName);
+	Instances->SetupAttachment(FieldActor->GetRootComponent());
+	Instances->RegisterComponent();
+
+	FUT_DoorInstanceField& Field = Fields.Add(DoorMesh);
+	Field.Instances = Instances;
+	return Instances;
+}
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/LoadTest/UT_LoadTestBotSubsystem.h"
+
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+
+bool UUT_LoadTestBotSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && FParse::Param(FCommandLine::Get(), TEXT("loadtestbot")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUT_LoadTestBotSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (GetWorld()->GetNetMode() != NM_Client)
+	{
+		return;
+	}
+
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	AUnrealTestCharacter* Character = PlayerController ? Cast<AUnrealTestCharacter>(PlayerController->GetPawn()) : nullptr;
+	if (!Character)
+	{
+		return;
+	}
+
+	const float Time = GetWorld()->GetTimeSeconds();
+	if (Time >= NextDirectionTime)
+	{
+		const float Yaw = FMath::FRandRange(0.f, 360.f);
+		MoveDirection = FRotator(0.f, Yaw, 0.f).Vector();
+		PlayerController->SetControlRotation(FRotator(0.f, Yaw, 0.f));
+		NextDirectionTime = Time + DIRECTION_INTERVAL;
+	}
+
+	Character->AddMovementInput(MoveDirection);
+
+	if (FMath::FRand() < JUMP_CHANCE)
+	{
+		Character->Jump();
+	}
+
+	if (Time >= NextActionTime)
+	{
+		Character->Server_OnAction();
+		NextActionTime = Time + ACTION_INTERVAL;
+	}
+}
+
+TStatId UUT_LoadTestBotSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_LoadTestBotSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/LoadTest/UT_LoadTestCommandlet.h"
+
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+
+#include "UnrealTest/UT_Stats.h"
+
+UUT_LoadTestCommandlet::UUT_LoadTestCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UUT_LoadTestCommandlet::Main(const FString& Params)
+{
+	int32 NumClients = 8;
+	int32 Port = 7777;
+	float Duration = 120.f;
+	FString Map = TEXT("ThirdPersonMap");
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("LoadTest") / TEXT("LoadTest.csv");
+
+	FParse::Value(*Params, TEXT("clients="), NumClients);
+	FParse::Value(*Params, TEXT("port="), Port);
+	FParse::Value(*Params, TEXT("duration="), Duration);
+	FParse::Value(*Params, TEXT("map="), Map);
+	FParse::Value(*Params, TEXT("csv="), ReportPath);
+	ReportPath = FPaths::ConvertRelativePathToFull(ReportPath);
+
+	// MaxPlayers of DefaultGame.ini would turn most bots away as server full
+	const FString ServerArguments = FString::Printf(TEXT("%s?MaxPlayers=%d -server -nullrhi -nosound -unattended -log -port=%d -loadtest -loadtestduration=%.1f -loadtestcsv=\"%s\""),
+		*Map, NumClients, Port, Duration, *ReportPath);
+
+	FProcHandle Server = LaunchInstance(ServerArguments);
+	if (!Server.IsValid())
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("Load test could not start the server"));
+		return 1;
+	}
+
+	FPlatformProcess::Sleep(SERVER_BOOT_TIME);
+
+	TArray<FProcHandle> Clients;
+	const FString ClientArguments = FString::Printf(TEXT("127.0.0.1:%d -game -nullrhi -nosound -unattended -loadtestbot"), Port);
+	for (int32 i = 0; i < NumClients; i++)
+	{
+		FProcHandle Client = LaunchInstance(ClientArguments);
+		if (Client.IsValid())
+		{
+			Clients.Add(Client);
+		}
+	}
+	UE_LOG(LogUnrealTest, Display, TEXT("Load test running with %d of %d clients for %.1f seconds"), Clients.Num(), NumClients, Duration);
+
+	// The server writes the report and exits by itself once the duration is over
+	const double Timeout = FPlatformTime::Seconds() + Duration + SERVER_TIMEOUT_MARGIN;
+	while (FPlatformProcess::IsProcRunning(Server) && FPlatformTime::Seconds() < Timeout)
+	{
+		FPlatformProcess::Sleep(1.f);
+	}
+
+	int32 Result = 0;
+	if (FPlatformProcess::IsProcRunning(Server))
+	{
+		UE_LOG(LogUnrealTest, Error, TEXT("Load test server did not finish in time"));
+		FPlatformProcess::TerminateProc(Server, true);
+		Result = 1;
+	}
+	FPlatformProcess::CloseProc(Server);
+
+	for (FProcHandle& Client : Clients)
+	{
+		FPlatformProcess::TerminateProc(Client, true);
+		FPlatformProcess::CloseProc(Client);
+	}
+
+	UE_LOG(LogUnrealTest, Display, TEXT("Load test report: %s"), *ReportPath);
+	return Result;
+}
+
+FProcHandle UUT_LoadTestCommandlet::LaunchInstance(const FString& Arguments) const
+{
+	const FString ProjectPath = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString CommandLine = FString::Printf(TEXT("\"%s\" %s"), *ProjectPath, *Arguments);
+	return FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *CommandLine, true, true, true, nullptr, 0, nullptr, nullptr);
+}
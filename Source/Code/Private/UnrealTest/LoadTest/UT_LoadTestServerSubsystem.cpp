@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/LoadTest/UT_LoadTestServerSubsystem.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "UnrealTest/UT_Stats.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Game/UT_DeathMatchGameMode.h"
+#include "UnrealTest/Net/UT_NetCounters.h"
+
+bool UUT_LoadTestServerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld() && FParse::Param(FCommandLine::Get(), TEXT("loadtest")) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UUT_LoadTestServerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("loadtestduration="), Duration);
+	if (!FParse::Value(FCommandLine::Get(), TEXT("loadtestcsv="), ReportPath))
+	{
+		ReportPath = FPaths::ProjectSavedDir() / TEXT("LoadTest") / TEXT("LoadTest.csv");
+	}
+
+	FrameTimes.Reserve(FMath::CeilToInt(Duration * 120.f));
+	NextSampleTime = 1.f;
+	NextRespawnTime = WARMUP_TIME;
+	FUT_NetCounters::Reset();
+}
+
+void UUT_LoadTestServerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Main menu or client worlds have no say in the test
+	if (bReportWritten || GetWorld()->GetNetMode() == NM_Client || GetWorld()->GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
+
+	ElapsedTime += DeltaTime;
+	// DeltaTime is capped by NetServerMaxTickRate and would hide any regression below it
+	FrameTimes.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+	if (ElapsedTime >= NextSampleTime)
+	{
+		SampleConnections();
+		NextSampleTime += 1.f;
+	}
+
+	if (ElapsedTime >= NextRespawnTime)
+	{
+		ForceRespawn();
+		NextRespawnTime += RESPAWN_INTERVAL;
+	}
+
+	if (ElapsedTime >= Duration)
+	{
+		WriteReport();
+		bReportWritten = true;
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+TStatId UUT_LoadTestServerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_LoadTestServerSubsystem, STATGROUP_Tickables);
+}
+
+void UUT_LoadTestServerSubsystem::SampleConnections()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver || NetDriver->ClientConnections.Num() == 0)
+	{
+		return;
+	}
+
+	int64 TotalBytes = 0;
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		TotalBytes += Connection->OutBytesPerSecond;
+	}
+
+	MaxConnections = FMath::Max(MaxConnections, NetDriver->ClientConnections.Num());
+	BytesPerConnection.Add(static_cast<float>(TotalBytes) / NetDriver->ClientConnections.Num());
+}
+
+void UUT_LoadTestServerSubsystem::ForceRespawn()
+{
+	AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	if (!GameMode)
+	{
+		return;
+	}
+
+	TArray<APlayerController*> PlayerControllers;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (APlayerController* PlayerController = It->Get())
+		{
+			if (PlayerController->GetPawn())
+			{
+				PlayerControllers.Add(PlayerController);
+			}
+		}
+	}
+
+	if (PlayerControllers.Num() > 0)
+	{
+		APlayerController* PlayerController = PlayerControllers[FMath::RandHelper(PlayerControllers.Num())];
+
+		// Goes through the pawn pool like a real death would
+		AUT_DeathMatchGameMode* DeathMatchGameMode = Cast<AUT_DeathMatchGameMode>(GameMode);
+		AUnrealTestCharacter* Character = Cast<AUnrealTestCharacter>(PlayerController->GetPawn());
+		if (DeathMatchGameMode && Character)
+		{
+			DeathMatchGameMode->ReleasePawn(Character);
+		}
+		else
+		{
+			PlayerController->GetPawn()->Destroy();
+		}
+		GameMode->RestartPlayer(PlayerController);
+		NumRespawns++;
+	}
+}
+
+void UUT_LoadTestServerSubsystem::WriteReport() const
+{
+	TArray<float> SortedFrameTimes = FrameTimes;
+	SortedFrameTimes.Sort();
+
+	auto Percentile = [&SortedFrameTimes](float Fraction)
+	{
+		if (SortedFrameTimes.Num() == 0)
+		{
+			return 0.f;
+		}
+		const int32 Index = FMath::Clamp(FMath::FloorToInt(Fraction * SortedFrameTimes.Num()), 0, SortedFrameTimes.Num() - 1);
+		return SortedFrameTimes[Index];
+	};
+
+	float AverageBytes = 0.f;
+	for (const float Bytes : BytesPerConnection)
+	{
+		AverageBytes += Bytes;
+	}
+	AverageBytes = BytesPerConnection.Num() > 0 ? AverageBytes / BytesPerConnection.Num() : 0.f;
+
+	FString Report;
+	if (!IFileManager::Get().FileExists(*ReportPath))
+	{
+		Report += TEXT("Date,BuildVersion,Map,Duration,MaxConnections,Frames,GameThreadP50Ms,GameThreadP90Ms,GameThreadP99Ms,GameThreadMaxMs,AvgBytesPerConnectionPerSec,ServerRpcs,MulticastRpcs,Respawns\n");
+	}
+
+	Report += FString::Printf(TEXT("%s,%s,%s,%.1f,%d,%d,%.3f,%.3f,%.3f,%.3f,%.1f,%d,%d,%d\n"),
+		*FDateTime::Now().ToString(),
+		FApp::GetBuildVersion(),
+		*GetWorld()->GetMapName(),
+		ElapsedTime,
+		MaxConnections,
+		FrameTimes.Num(),
+		Percentile(0.5f),
+		Percentile(0.9f),
+		Percentile(0.99f),
+		SortedFrameTimes.Num() > 0 ? SortedFrameTimes.Last() : 0.f,
+		AverageBytes,
+		FUT_NetCounters::ServerRpcs,
+		FUT_NetCounters::MulticastRpcs,
+		NumRespawns);
+
+	FFileHelper::SaveStringToFile(Report, *ReportPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	UE_LOG(LogUnrealTest, Display, TEXT("Load test report appended to %s"), *ReportPath);
+}
@@ -0,0 +1,12 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_NetCounters.h"
+
+int32 FUT_NetCounters::ServerRpcs = 0;
+int32 FUT_NetCounters::MulticastRpcs = 0;
+
+void FUT_NetCounters::Reset()
+{
+	ServerRpcs = 0;
+	MulticastRpcs = 0;
+}
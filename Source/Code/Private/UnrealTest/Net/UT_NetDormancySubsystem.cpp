@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_NetDormancySubsystem.h"
+
+void UUT_NetDormancySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (AwakeActors.Num() == 0)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	for (int32 i = AwakeActors.Num() - 1; i >= 0; i--)
+	{
+		if (Now < DormantTimes[i])
+		{
+			continue;
+		}
+
+		if (IsValid(AwakeActors[i]))
+		{
+			AwakeActors[i]->SetNetDormancy(DORM_DormantAll);
+		}
+		AwakeActors.RemoveAtSwap(i, 1, false);
+		DormantTimes.RemoveAtSwap(i, 1, false);
+	}
+}
+
+TStatId UUT_NetDormancySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UUT_NetDormancySubsystem, STATGROUP_Tickables);
+}
+
+void UUT_NetDormancySubsystem::WakeActor(AActor* Actor, float AwakeSeconds)
+{
+	if (!Actor || !Actor->HasAuthority())
+	{
+		return;
+	}
+
+	const float DormantTime = GetWorld()->GetTimeSeconds() + AwakeSeconds;
+
+	const int32 Index = AwakeActors.Find(Actor);
+	if (Index != INDEX_NONE)
+	{
+		DormantTimes[Index] = FMath::Max(DormantTimes[Index], DormantTime);
+		return;
+	}
+
+	Actor->SetNetDormancy(DORM_Awake);
+	AwakeActors.Add(Actor);
+	DormantTimes.Add(DormantTime);
+}
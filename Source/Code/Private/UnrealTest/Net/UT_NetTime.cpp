@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_NetTime.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+
+float FUT_NetTime::GetServerTime(const UWorld* World)
+{
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+uint16 FUT_NetTime::Quantize(float ServerTime)
+{
+	return static_cast<uint16>(static_cast<uint32>(FMath::RoundToInt(ServerTime * 100.f)) & 0xFFFF);
+}
+
+float FUT_NetTime::GetElapsed(uint16 QuantizedTime, float ServerTime)
+{
+	// Unsigned subtraction handles the wrap
+	const uint16 ElapsedTicks = Quantize(ServerTime) - QuantizedTime;
+	return ElapsedTicks / 100.f;
+}
@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_PushModel.h"
+
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarPushModel(
+	TEXT("ut.PushModel"),
+	true,
+	TEXT("Register UnrealTest replicated properties as push based (1) or polled (0). Read when replication layouts are built."),
+	ECVF_Default);
+
+bool FUT_PushModel::IsEnabled()
+{
+	return CVarPushModel.GetValueOnAnyThread();
+}
+
+FDoRepLifetimeParams FUT_PushModel::MakeParams(ELifetimeCondition Condition)
+{
+	FDoRepLifetimeParams Params;
+	Params.Condition = Condition;
+	Params.bIsPushBased = IsEnabled();
+	return Params;
+}
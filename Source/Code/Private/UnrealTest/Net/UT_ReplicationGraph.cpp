@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_ReplicationGraph.h"
+
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+#include "UnrealTest/Character/UT_PlayerState.h"
+#include "UnrealTest/Character/UnrealTestCharacter.h"
+#include "UnrealTest/Items/Door.h"
+
+UUT_ReplicationGraph::UUT_ReplicationGraph()
+{
+	GridCellSize = 10000.f;
+	SpatialBiasX = -150000.f;
+	SpatialBiasY = -200000.f;
+	ReducedRateDistance = 3000.f;
+	ReducedRatePeriodScale = 3;
+	CharacterReplicationPeriodFrame = 1;
+}
+
+void UUT_ReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	ClassRepNodePolicies.Set(AUnrealTestCharacter::StaticClass(), EUT_ClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(ADoor::StaticClass(), EUT_ClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EUT_ClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EUT_ClassRepNodeMapping::RelevantAllConnections);
+	// Added by the connection node of its owner
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EUT_ClassRepNodeMapping::NotRouted);
+
+	// Fallback for every class without explicit settings
+	InitClassReplicationInfo(AActor::StaticClass(), true);
+	InitClassReplicationInfo(AUnrealTestCharacter::StaticClass(), true);
+	InitClassReplicationInfo(ADoor::StaticClass(), true);
+	InitClassReplicationInfo(AGameStateBase::StaticClass(), false);
+	InitClassReplicationInfo(APlayerState::StaticClass(), false);
+	InitClassReplicationInfo(APlayerController::StaticClass(), false);
+
+	CharacterReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(GetDefault<AUnrealTestCharacter>()->NetUpdateFrequency);
+}
+
+void UUT_ReplicationGraph::InitClassReplicationInfo(UClass* Class, bool bSpatialize)
+{
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+
+	FClassReplicationInfo ClassInfo;
+	if (bSpatialize)
+	{
+		ClassInfo.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
+	}
+	ClassInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CDO->NetUpdateFrequency);
+
+	GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+}
+
+void UUT_ReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	TeamsNode = CreateNewNode<UUT_ReplicationGraphNode_Teams>();
+	AddGlobalGraphNode(TeamsNode);
+}
+
+void UUT_ReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	UUT_ReplicationGraphNode_TeamRelevancy_ForConnection* TeamRelevancyNode = CreateNewNode<UUT_ReplicationGraphNode_TeamRelevancy_ForConnection>();
+	AddConnectionGraphNode(TeamRelevancyNode, RepGraphConnection);
+}
+
+EUT_ClassRepNodeMapping UUT_ReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	// Explicit policies of the class or its parents, results for new classes are cached below
+	if (const EUT_ClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	const AActor* CDO = Class->GetDefaultObject<AActor>();
+	EUT_ClassRepNodeMapping Policy = EUT_ClassRepNodeMapping::Spatialize_Dynamic;
+	if (CDO->bAlwaysRelevant)
+	{
+		Policy = EUT_ClassRepNodeMapping::RelevantAllConnections;
+	}
+	else if (CDO->bOnlyRelevantToOwner)
+	{
+		Policy = EUT_ClassRepNodeMapping::NotRouted;
+	}
+	else if (CDO->GetRootComponent() && CDO->GetRootComponent()->Mobility == EComponentMobility::Static)
+	{
+		Policy = EUT_ClassRepNodeMapping::Spatialize_Static;
+	}
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UUT_ReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EUT_ClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+
+	if (ActorInfo.Class->IsChildOf(AUnrealTestCharacter::StaticClass()))
+	{
+		TeamsNode->NotifyAddNetworkActor(ActorInfo);
+	}
+}
+
+void UUT_ReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EUT_ClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case EUT_ClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+
+	if (ActorInfo.Class->IsChildOf(AUnrealTestCharacter::StaticClass()))
+	{
+		TeamsNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+}
+
+const FActorRepListRefView* UUT_ReplicationGraph::GetTeamCharacters(int32 TeamNum) const
+{
+	return TeamsNode ? TeamsNode->GetTeamCharacters(TeamNum) : nullptr;
+}
+
+UUT_ReplicationGraphNode_Teams::UUT_ReplicationGraphNode_Teams()
+{
+	bRequiresPrepareForReplicationCall = true;
+}
+
+void UUT_ReplicationGraphNode_Teams::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Characters.Add(ActorInfo.Actor);
+}
+
+bool UUT_ReplicationGraphNode_Teams::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	return Characters.RemoveFast(ActorInfo.Actor);
+}
+
+void UUT_ReplicationGraphNode_Teams::NotifyResetAllNetworkActors()
+{
+	Characters.Reset();
+	TeamCharacters.Reset();
+}
+
+void UUT_ReplicationGraphNode_Teams::PrepareForReplication()
+{
+	for (TPair<int32, FActorRepListRefView>& Pair : TeamCharacters)
+	{
+		Pair.Value.Reset();
+	}
+
+	for (AActor* Actor : Characters)
+	{
+		const int32 TeamNum = CastChecked<AUnrealTestCharacter>(Actor)->GetPlayerTeam();
+		if (TeamNum != INDEX_NONE)
+		{
+			TeamCharacters.FindOrAdd(TeamNum).Add(Actor);
+		}
+	}
+}
+
+const FActorRepListRefView* UUT_ReplicationGraphNode_Teams::GetTeamCharacters(int32 TeamNum) const
+{
+	return TeamCharacters.Find(TeamNum);
+}
+
+void UUT_ReplicationGraphNode_TeamRelevancy_ForConnection::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	const UUT_ReplicationGraph* Graph = CastChecked<UUT_ReplicationGraph>(GetOuter());
+
+	ReplicationActorList.Reset();
+
+	int32 LastTeamNum = INDEX_NONE;
+	for (const FNetViewer& CurViewer : Params.Viewers)
+	{
+		ReplicationActorList.ConditionalAdd(CurViewer.InViewer);
+		ReplicationActorList.ConditionalAdd(CurViewer.ViewTarget);
+
+		const APlayerController* PlayerController = Cast<APlayerController>(CurViewer.InViewer);
+		const AUT_PlayerState* PlayerState = PlayerController ? PlayerController->GetPlayerState<AUT_PlayerState>() : nullptr;
+		const int32 TeamNum = PlayerState ? PlayerState->GetTeamNum() : INDEX_NONE;
+
+		// Split screen viewers usually share a team
+		if (TeamNum != INDEX_NONE && TeamNum != LastTeamNum)
+		{
+			if (const FActorRepListRefView* TeamList = Graph->GetTeamCharacters(TeamNum))
+			{
+				if (TeamList->Num() > 0)
+				{
+					Params.OutGatheredReplicationLists.AddReplicationActorList(*TeamList);
+				}
+			}
+			LastTeamNum = TeamNum;
+		}
+	}
+
+	Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationActorList);
+
+	UpdateCharacterRates(Params);
+}
+
+void UUT_ReplicationGraphNode_TeamRelevancy_ForConnection::UpdateCharacterRates(const FConnectionGatherActorListParameters& Params) const
+{
+	const UUT_ReplicationGraph* Graph = CastChecked<UUT_ReplicationGraph>(GetOuter());
+	if (!Graph->TeamsNode || Graph->ReducedRatePeriodScale <= 1)
+	{
+		return;
+	}
+
+	const uint16 FullPeriod = Graph->GetCharacterReplicationPeriodFrame();
+	const uint16 ReducedPeriod = FullPeriod * Graph->ReducedRatePeriodScale;
+	const float ReducedRateDistanceSquared = FMath::Square(Graph->ReducedRateDistance);
+
+	for (AActor* Actor : Graph->TeamsNode->GetCharacters())
+	{
+		// Close and in front of any viewer keeps the full rate, the connection's own characters always do
+		bool bFullRate = false;
+		for (const FNetViewer& CurViewer : Params.Viewers)
+		{
+			if (Actor == CurViewer.ViewTarget || Actor->GetOwner() == CurViewer.InViewer)
+			{
+				bFullRate = true;
+				break;
+			}
+
+			const FVector ToActor = Actor->GetActorLocation() - CurViewer.ViewLocation;
+			const float DistanceSquared = ToActor.SizeSquared();
+			const bool bInView = FVector::DotProduct(ToActor, CurViewer.ViewDir) >= VIEW_CONE_COS * FMath::Sqrt(DistanceSquared);
+			if (DistanceSquared <= FMath::Square(FULL_RATE_RADIUS) || (DistanceSquared <= ReducedRateDistanceSquared && bInView))
+			{
+				bFullRate = true;
+				break;
+			}
+		}
+
+		FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+		ConnectionInfo.ReplicationPeriodFrame = bFullRate ? FullPeriod : ReducedPeriod;
+	}
+}
@@ -0,0 +1,334 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Net/UT_SessionSubsystem.h"
+
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerController.h"
+#include "Kismet/GameplayStatics.h"
+#include "OnlineSubsystem.h"
+#include "OnlineSubsystemUtils.h"
+
+#include "UnrealTest/UT_Stats.h"
+
+void UUT_SessionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (IOnlineSessionPtr Sessions = GetSessionInterface())
+	{
+		CreateSessionHandle = Sessions->AddOnCreateSessionCompleteDelegate_Handle(FOnCreateSessionCompleteDelegate::CreateUObject(this, &UUT_SessionSubsystem::HandleCreateSessionComplete));
+		DestroySessionHandle = Sessions->AddOnDestroySessionCompleteDelegate_Handle(FOnDestroySessionCompleteDelegate::CreateUObject(this, &UUT_SessionSubsystem::HandleDestroySessionComplete));
+		FindSessionsHandle = Sessions->AddOnFindSessionsCompleteDelegate_Handle(FOnFindSessionsCompleteDelegate::CreateUObject(this, &UUT_SessionSubsystem::HandleFindSessionsComplete));
+		CancelFindSessionsHandle = Sessions->AddOnCancelFindSessionsCompleteDelegate_Handle(FOnCancelFindSessionsCompleteDelegate::CreateUObject(this, &UUT_SessionSubsystem::HandleCancelFindSessionsComplete));
+		JoinSessionHandle = Sessions->AddOnJoinSessionCompleteDelegate_Handle(FOnJoinSessionCompleteDelegate::CreateUObject(this, &UUT_SessionSubsystem::HandleJoinSessionComplete));
+	}
+}
+
+void UUT_SessionSubsystem::Deinitialize()
+{
+	StopSendingPages();
+
+	if (IOnlineSessionPtr Sessions = GetSessionInterface())
+	{
+		Sessions->ClearOnCreateSessionCompleteDelegate_Handle(CreateSessionHandle);
+		Sessions->ClearOnDestroySessionCompleteDelegate_Handle(DestroySessionHandle);
+		Sessions->ClearOnFindSessionsCompleteDelegate_Handle(FindSessionsHandle);
+		Sessions->ClearOnCancelFindSessionsCompleteDelegate_Handle(CancelFindSessionsHandle);
+		Sessions->ClearOnJoinSessionCompleteDelegate_Handle(JoinSessionHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UUT_SessionSubsystem::CreateSession(const FString& MapName, int32 MaxConnections, bool bIsLAN)
+{
+	PendingMapName = MapName;
+	PendingMaxConnections = MaxConnections;
+	bPendingCreateLAN = bIsLAN;
+	bCreatePending = true;
+
+	StartCreateSession();
+}
+
+void UUT_SessionSubsystem::StartCreateSession()
+{
+	IOnlineSessionPtr Sessions = GetSessionInterface();
+	if (!Sessions)
+	{
+		bCreatePending = false;
+		OnCreateSessionComplete.Broadcast(false);
+		return;
+	}
+
+	// Continues from HandleDestroySessionComplete
+	if (Sessions->GetNamedSession(NAME_GameSession))
+	{
+		Sessions->DestroySession(NAME_GameSession);
+		return;
+	}
+
+	FOnlineSessionSettings Settings;
+	Settings.NumPublicConnections = PendingMaxConnections;
+	Settings.bIsLANMatch = bPendingCreateLAN;
+	Settings.bShouldAdvertise = true;
+	Settings.bUsesPresence = true;
+	Settings.bAllowJoinInProgress = true;
+	Settings.bAllowJoinViaPresence = true;
+	Settings.Set(SETTING_MAPNAME, PendingMapName, EOnlineDataAdvertisementType::ViaOnlineService);
+
+	if (!Sessions->CreateSession(0, NAME_GameSession, Settings))
+	{
+		HandleCreateSessionComplete(NAME_GameSession, false);
+	}
+}
+
+void UUT_SessionSubsystem::HandleCreateSessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionName != NAME_GameSession || !bCreatePending)
+	{
+		return;
+	}
+	bCreatePending = false;
+
+	if (bWasSuccessful && !PendingMapName.IsEmpty())
+	{
+		UGameplayStatics::OpenLevel(GetGameInstance(), FName(*PendingMapName), true, TEXT("listen"));
+	}
+	OnCreateSessionComplete.Broadcast(bWasSuccessful);
+}
+
+void UUT_SessionSubsystem::HandleDestroySessionComplete(FName SessionName, bool bWasSuccessful)
+{
+	if (SessionName == NAME_GameSession && bCreatePending)
+	{
+		StartCreateSession();
+	}
+}
+
+void UUT_SessionSubsystem::FindSessions(bool bIsLAN, bool bForceRefresh)
+{
+	StopSendingPages();
+
+	if (!bForceRefresh && IsCacheFresh(bIsLAN))
+	{
+		StartSendingPages();
+		return;
+	}
+
+	bPendingFindLAN = bIsLAN;
+	bFindPending = true;
+
+	// A search in flight is stale now, the new one starts once it is cancelled, possibly right away
+	if (IsSearching())
+	{
+		CancelSearchInFlight();
+		return;
+	}
+
+	StartFindSessions();
+}
+
+void UUT_SessionSubsystem::StartFindSessions()
+{
+	bFindPending = false;
+
+	IOnlineSessionPtr Sessions = GetSessionInterface();
+	if (!Sessions)
+	{
+		OnSessionSearchComplete.Broadcast(0);
+		return;
+	}
+
+	ActiveSearch = MakeShared<FOnlineSessionSearch>();
+	ActiveSearch->bIsLanQuery = bPendingFindLAN;
+	ActiveSearch->MaxSearchResults = MAX_SEARCH_RESULTS;
+	ActiveSearch->TimeoutInSeconds = SEARCH_TIMEOUT;
+	ActiveSearch->QuerySettings.Set(SEARCH_PRESENCE, true, EOnlineComparisonOp::Equals);
+
+	if (!Sessions->FindSessions(0, ActiveSearch.ToSharedRef()))
+	{
+		HandleFindSessionsComplete(false);
+	}
+}
+
+void UUT_SessionSubsystem::CancelFindSessions()
+{
+	bFindPending = false;
+	StopSendingPages();
+	CancelSearchInFlight();
+}
+
+void UUT_SessionSubsystem::CancelSearchInFlight()
+{
+	IOnlineSessionPtr Sessions = GetSessionInterface();
+	if (Sessions && IsSearching() && !bCancelInFlight)
+	{
+		bCancelInFlight = true;
+		Sessions->CancelFindSessions();
+	}
+}
+
+void UUT_SessionSubsystem::HandleCancelFindSessionsComplete(bool bWasSuccessful)
+{
+	bCancelInFlight = false;
+	ActiveSearch.Reset();
+
+	if (bFindPending)
+	{
+		StartFindSessions();
+	}
+}
+
+void UUT_SessionSubsystem::HandleFindSessionsComplete(bool bWasSuccessful)
+{
+	// Results of a cancelled search are dropped
+	if (!ActiveSearch.IsValid() || bCancelInFlight || ActiveSearch->SearchState == EOnlineAsyncTaskState::InProgress)
+	{
+		return;
+	}
+
+	const TSharedPtr<FOnlineSessionSearch> Search = ActiveSearch;
+	ActiveSearch.Reset();
+
+	CachedResults.Reset();
+	SortedResults.Reset();
+	if (bWasSuccessful)
+	{
+		for (const FOnlineSessionSearchResult& Result : Search->SearchResults)
+		{
+			if (Result.IsValid())
+			{
+				SortedResults.Add(CachedResults.Add(Result));
+			}
+		}
+		SortedResults.Sort([this](int32 A, int32 B) { return CachedResults[A].PingInMs < CachedResults[B].PingInMs; });
+
+		bCachedLAN = Search->bIsLanQuery;
+		CacheTime = FPlatformTime::Seconds();
+	}
+	else
+	{
+		CacheTime = -1.0;
+	}
+
+	StartSendingPages();
+}
+
+void UUT_SessionSubsystem::JoinSession(int32 ResultIndex)
+{
+	IOnlineSessionPtr Sessions = GetSessionInterface();
+	if (!Sessions || !CachedResults.IsValidIndex(ResultIndex))
+	{
+		OnJoinSessionComplete.Broadcast(false);
+		return;
+	}
+
+	// Joining is what the search was for
+	CancelFindSessions();
+
+	if (!Sessions->JoinSession(0, NAME_GameSession, CachedResults[ResultIndex]))
+	{
+		HandleJoinSessionComplete(NAME_GameSession, EOnJoinSessionCompleteResult::UnknownError);
+	}
+}
+
+void UUT_SessionSubsystem::HandleJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result)
+{
+	if (SessionName != NAME_GameSession)
+	{
+		return;
+	}
+
+	const bool bJoined = Result == EOnJoinSessionCompleteResult::Success;
+	if (bJoined)
+	{
+		// Joined results are likely full or gone next time
+		CacheTime = -1.0;
+
+		// No player controller without a local player, e.g. in automation tests
+		FString ConnectString;
+		IOnlineSessionPtr Sessions = GetSessionInterface();
+		APlayerController* PlayerController = GetGameInstance()->GetFirstLocalPlayerController();
+		if (PlayerController && Sessions && Sessions->GetResolvedConnectString(NAME_GameSession, ConnectString))
+		{
+			PlayerController->ClientTravel(ConnectString, TRAVEL_Absolute);
+		}
+		else
+		{
+			UE_LOG(LogUnrealTest, Warning, TEXT("Joined session but could not travel to it"));
+		}
+	}
+	OnJoinSessionComplete.Broadcast(bJoined);
+}
+
+bool UUT_SessionSubsystem::IsSearching() const
+{
+	return ActiveSearch.IsValid() && ActiveSearch->SearchState == EOnlineAsyncTaskState::InProgress;
+}
+
+void UUT_SessionSubsystem::GetSessionPage(int32 PageIndex, TArray<FUT_SessionInfo>& OutSessions) const
+{
+	OutSessions.Reset();
+
+	const int32 FirstIndex = PageIndex * PAGE_SIZE;
+	const int32 LastIndex = FMath::Min(FirstIndex + PAGE_SIZE, SortedResults.Num());
+	for (int32 i = FirstIndex; i < LastIndex; i++)
+	{
+		const FOnlineSessionSearchResult& Result = CachedResults[SortedResults[i]];
+
+		FUT_SessionInfo& Info = OutSessions.AddDefaulted_GetRef();
+		Info.ResultIndex = SortedResults[i];
+		Info.OwnerName = Result.Session.OwningUserName;
+		Info.PingInMs = Result.PingInMs;
+		Info.MaxConnections = Result.Session.SessionSettings.NumPublicConnections;
+		Info.NumOpenConnections = Result.Session.NumOpenPublicConnections;
+	}
+}
+
+IOnlineSessionPtr UUT_SessionSubsystem::GetSessionInterface() const
+{
+	const IOnlineSubsystem* OnlineSubsystem = Online::GetSubsystem(GetWorld());
+	return OnlineSubsystem ? OnlineSubsystem->GetSessionInterface() : nullptr;
+}
+
+bool UUT_SessionSubsystem::IsCacheFresh(bool bIsLAN) const
+{
+	return CacheTime >= 0.0 && bCachedLAN == bIsLAN && FPlatformTime::Seconds() - CacheTime < CACHE_TTL;
+}
+
+void UUT_SessionSubsystem::StartSendingPages()
+{
+	StopSendingPages();
+
+	NextPageIndex = 0;
+	PageTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UUT_SessionSubsystem::SendNextPage));
+}
+
+void UUT_SessionSubsystem::StopSendingPages()
+{
+	if (PageTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PageTickerHandle);
+		PageTickerHandle.Reset();
+	}
+}
+
+bool UUT_SessionSubsystem::SendNextPage(float DeltaTime)
+{
+	const int32 NumPages = FMath::DivideAndRoundUp(SortedResults.Num(), PAGE_SIZE);
+	if (NextPageIndex < NumPages)
+	{
+		TArray<FUT_SessionInfo> Page;
+		GetSessionPage(NextPageIndex, Page);
+		OnSessionPageReady.Broadcast(NextPageIndex, Page);
+		NextPageIndex++;
+	}
+
+	if (NextPageIndex >= NumPages)
+	{
+		PageTickerHandle.Reset();
+		OnSessionSearchComplete.Broadcast(SortedResults.Num());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/Tests/UT_BenchmarkUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "Engine/Engine.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "UnrealTest/Game/UT_DeathMatchGameMode.h"
+
+FUT_BenchmarkWorld::FUT_BenchmarkWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("UT_BenchmarkWorld"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Authority game mode, so BeginPlay starts play and actors spawned afterwards begin play right away
+	const FURL URL(TEXT("?game=/Script/UnrealTest.UT_DeathMatchGameMode"));
+	World->SetGameMode(URL);
+	GameMode = Cast<AUT_DeathMatchGameMode>(World->GetAuthGameMode());
+
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+}
+
+FUT_BenchmarkWorld::~FUT_BenchmarkWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+FUT_BenchmarkReport::FUT_BenchmarkReport(const FString& InName)
+	: Name(InName)
+{
+}
+
+void FUT_BenchmarkReport::Measure(const FString& Key, int32 Iterations, TFunctionRef<void()> Body)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Body();
+	}
+	const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+
+	Results.Add(Key, ElapsedTime * 1.0e9 / FMath::Max(Iterations, 1));
+}
+
+bool FUT_BenchmarkReport::Finish(FAutomationTestBase& Test) const
+{
+	const TSharedRef<FJsonObject> ResultsObject = MakeShared<FJsonObject>();
+	for (const TPair<FString, double>& Result : Results)
+	{
+		ResultsObject->SetNumberField(Result.Key, Result.Value);
+		Test.AddInfo(FString::Printf(TEXT("%s %s: %.1f ns"), *Name, *Result.Key, Result.Value));
+	}
+
+	FString Json;
+	FJsonSerializer::Serialize(ResultsObject, TJsonWriterFactory<>::Create(&Json));
+
+	const FString ResultPath = FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("Benchmarks") / (Name + TEXT(".json"));
+	const FString BaselinePath = FPaths::ProjectDir() / TEXT("Benchmarks") / (Name + TEXT(".json"));
+	FFileHelper::SaveStringToFile(Json, *ResultPath);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("UTUpdateBenchmarkBaseline")))
+	{
+		FFileHelper::SaveStringToFile(Json, *BaselinePath);
+		return true;
+	}
+
+	FString BaselineJson;
+	TSharedPtr<FJsonObject> BaselineObject;
+	if (!FFileHelper::LoadFileToString(BaselineJson, *BaselinePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), BaselineObject) || !BaselineObject.IsValid())
+	{
+		Test.AddWarning(FString::Printf(TEXT("No benchmark baseline at %s"), *BaselinePath));
+		return true;
+	}
+
+	bool bPassed = true;
+	for (const TPair<FString, double>& Result : Results)
+	{
+		double Baseline = 0.0;
+		if (BaselineObject->TryGetNumberField(Result.Key, Baseline) && Result.Value > Baseline * (1.0 + REGRESSION_TOLERANCE))
+		{
+			Test.AddError(FString::Printf(TEXT("%s %s regressed: %.1f ns, baseline %.1f ns"), *Name, *Result.Key, Result.Value, Baseline));
+			bPassed = false;
+		}
+	}
+	return bPassed;
+}
+
+#endif
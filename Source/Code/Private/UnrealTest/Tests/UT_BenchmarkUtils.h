@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FAutomationTestBase;
+class AUT_DeathMatchGameMode;
+
+/**
+ * Headless game world for benchmarks that has begun play, with the death match game mode as authority game mode.
+ * The world is torn down when this goes out of scope.
+ */
+class FUT_BenchmarkWorld
+{
+public:
+	FUT_BenchmarkWorld();
+	~FUT_BenchmarkWorld();
+
+	FORCEINLINE UWorld* GetWorld() const { return World; }
+	FORCEINLINE AUT_DeathMatchGameMode* GetGameMode() const { return GameMode; }
+
+private:
+	UWorld* World = nullptr;
+	AUT_DeathMatchGameMode* GameMode = nullptr;
+};
+
+/**
+ * Collects nanoseconds per operation of a benchmark and writes them to Saved/Automation/Benchmarks/<Name>.json.
+ * Results slower than Benchmarks/<Name>.json in the project by more than the tolerance fail the test.
+ * Run with -UTUpdateBenchmarkBaseline to replace the baseline with the current results.
+ */
+class FUT_BenchmarkReport
+{
+public:
+	explicit FUT_BenchmarkReport(const FString& InName);
+
+	// Times Iterations calls of Body and records the average under Key
+	void Measure(const FString& Key, int32 Iterations, TFunctionRef<void()> Body);
+
+	// Writes the results and compares them to the baseline, returns false on regression
+	bool Finish(FAutomationTestBase& Test) const;
+
+private:
+	FString Name;
+	TMap<FString, double> Results;
+
+	// Allowed slowdown against the baseline, timings on shared machines are noisy
+	const double REGRESSION_TOLERANCE = 0.25;
+};
+
+#endif
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/NetSerialization.h"
+#include "GameFramework/PlayerController.h"
+#include "UObject/Package.h"
+
+#include "UnrealTest/Character/UT_PlayerState.h"
+#include "UnrealTest/Components/UT_CustomPlayerStart.h"
+#include "UnrealTest/Game/UT_DeathMatchGameMode.h"
+#include "UnrealTest/Game/UT_SpawnPointSubsystem.h"
+#include "UnrealTest/Items/Door.h"
+#include "UnrealTest/Tests/UT_BenchmarkUtils.h"
+
+// Run headless with: UnrealEditor-Cmd UnrealTest.uproject -nullrhi -unattended -ExecCmds="Automation RunTests UnrealTest.Benchmark; Quit"
+
+namespace UT_Benchmark
+{
+	// Seconds between two respawns, longer than the recent use window of the spawn points
+	const float RESPAWN_INTERVAL = 2.5f;
+
+	APlayerController* SpawnPlayer(UWorld* World, int32 TeamNum)
+	{
+		// Player controllers get their player state from the game mode of the game state
+		APlayerController* PlayerController = World->SpawnActor<APlayerController>();
+		if (AUT_PlayerState* PlayerState = PlayerController->GetPlayerState<AUT_PlayerState>())
+		{
+			PlayerState->SetTeamNum(TeamNum);
+		}
+		return PlayerController;
+	}
+
+	void SpawnStarts(UWorld* World, int32 NumStarts, int32 NumTeams)
+	{
+		for (int32 i = 0; i < NumStarts; i++)
+		{
+			const FTransform Transform(FVector(i * 200.f, 0.f, 0.f));
+			AUT_CustomPlayerStart* PlayerStart = World->SpawnActorDeferred<AUT_CustomPlayerStart>(AUT_CustomPlayerStart::StaticClass(), Transform);
+			PlayerStart->SetSpawnTeam(i % NumTeams);
+			PlayerStart->FinishSpawning(Transform);
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUT_ChoosePlayerStartBenchmark, "UnrealTest.Benchmark.ChoosePlayerStart", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FUT_ChoosePlayerStartBenchmark::RunTest(const FString& Parameters)
+{
+	FUT_BenchmarkReport Report(TEXT("ChoosePlayerStart"));
+
+	for (const int32 NumStarts : { 16, 64, 256, 1024 })
+	{
+		FUT_BenchmarkWorld BenchmarkWorld;
+		UT_Benchmark::SpawnStarts(BenchmarkWorld.GetWorld(), NumStarts, 2);
+		APlayerController* PlayerController = UT_Benchmark::SpawnPlayer(BenchmarkWorld.GetWorld(), 0);
+
+		UWorld* World = BenchmarkWorld.GetWorld();
+		AUT_DeathMatchGameMode* GameMode = BenchmarkWorld.GetGameMode();
+		const UUT_SpawnPointSubsystem* SpawnPoints = World->GetSubsystem<UUT_SpawnPointSubsystem>();
+		if (!TestNotNull(TEXT("Benchmark world has the death match game mode"), GameMode) || !TestNotNull(TEXT("Benchmark world has spawn points"), SpawnPoints))
+		{
+			return false;
+		}
+
+		// Must come from the team bucket of the registry, not the actor iterator fallback
+		AUT_CustomPlayerStart* PlayerStart = Cast<AUT_CustomPlayerStart>(GameMode->ChoosePlayerStart(PlayerController));
+		TestTrue(TEXT("ChoosePlayerStart claims a start of the team"), PlayerStart && SpawnPoints->GetTeamStarts(0).Contains(PlayerStart));
+		TestEqual(TEXT("Every team start is registered"), SpawnPoints->GetTeamStarts(0).Num(), NumStarts / 2);
+
+		// Players respawn seconds apart, claims never all hit the recently used window
+		Report.Measure(FString::Printf(TEXT("Starts_%d"), NumStarts), 10000, [World, GameMode, PlayerController]()
+		{
+			World->TimeSeconds += UT_Benchmark::RESPAWN_INTERVAL;
+			GameMode->ChoosePlayerStart(PlayerController);
+		});
+	}
+
+	return Report.Finish(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUT_ChooseTeamBenchmark, "UnrealTest.Benchmark.ChooseTeam", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FUT_ChooseTeamBenchmark::RunTest(const FString& Parameters)
+{
+	FUT_BenchmarkReport Report(TEXT("ChooseTeam"));
+
+	for (const int32 NumPlayers : { 2, 16, 64 })
+	{
+		FUT_BenchmarkWorld BenchmarkWorld;
+		AUT_PlayerState* LastPlayerState = nullptr;
+		for (int32 i = 0; i < NumPlayers; i++)
+		{
+			LastPlayerState = UT_Benchmark::SpawnPlayer(BenchmarkWorld.GetWorld(), i % 2)->GetPlayerState<AUT_PlayerState>();
+		}
+
+		AUT_DeathMatchGameMode* GameMode = BenchmarkWorld.GetGameMode();
+		TestEqual(TEXT("Teams stay balanced"), GameMode->ChooseTeam(LastPlayerState), (NumPlayers % 2 == 0) ? 0 : 1);
+
+		Report.Measure(FString::Printf(TEXT("Players_%d"), NumPlayers), 100000, [GameMode, LastPlayerState]()
+		{
+			GameMode->ChooseTeam(LastPlayerState);
+		});
+	}
+
+	return Report.Finish(*this);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUT_DoorBenchmark, "UnrealTest.Benchmark.Door", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FUT_DoorBenchmark::RunTest(const FString& Parameters)
+{
+	FUT_BenchmarkReport Report(TEXT("Door"));
+
+	for (const int32 NumDoors : { 16, 128, 512 })
+	{
+		FUT_BenchmarkWorld BenchmarkWorld;
+		TArray<ADoor*> Doors;
+		for (int32 i = 0; i < NumDoors; i++)
+		{
+			Doors.Add(BenchmarkWorld.GetWorld()->SpawnActor<ADoor>(FVector(i * 300.f, 0.f, 0.f), FRotator::ZeroRotator));
+		}
+
+		// Toggles every door, each toggle wakes it and hands it to the animation subsystem
+		Report.Measure(FString::Printf(TEXT("Toggle_%d"), NumDoors), 100, [&Doors]()
+		{
+			for (ADoor* Door : Doors)
+			{
+				Door->ToggleDoor(FVector::ForwardVector);
+			}
+		});
+
+		// Serializes the replicated state of every door as the net driver would
+		int64 NumBits = 0;
+		Report.Measure(FString::Printf(TEXT("Serialize_%d"), NumDoors), 100, [&Doors, &NumBits]()
+		{
+			FNetBitWriter Writer(nullptr, 0);
+			for (ADoor* Door : Doors)
+			{
+				bool bSuccess = false;
+				FDoorState DoorState = Door->GetDoorState();
+				DoorState.NetSerialize(Writer, nullptr, bSuccess);
+			}
+			NumBits = Writer.GetNumBits();
+		});
+		TestEqual(TEXT("Door state stays at 19 bits"), NumBits, static_cast<int64>(NumDoors) * 19);
+	}
+
+	return Report.Finish(*this);
+}
+
+#endif
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSubsystemUtils.h"
+
+#include "UnrealTest/Net/UT_SessionSubsystem.h"
+
+// Run with: UnrealEditor-Cmd UnrealTest.uproject -nullrhi -unattended -ExecCmds="Automation RunTests UnrealTest.Net.Sessions; Quit"
+// Each game instance has its own world context, so its own OnlineSubsystemNull instance and LAN beacon on loopback.
+
+namespace UT_SessionTest
+{
+	// Longer than a LAN search
+	const double STEP_TIMEOUT = 15.0;
+
+	struct FState
+	{
+		UGameInstance* Host = nullptr;
+		UGameInstance* Client = nullptr;
+	};
+
+	UGameInstance* CreateGameInstance()
+	{
+		UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+		GameInstance->AddToRoot();
+		GameInstance->InitializeStandalone();
+		return GameInstance;
+	}
+
+	void DestroyGameInstance(UGameInstance* GameInstance)
+	{
+		if (!GameInstance)
+		{
+			return;
+		}
+
+		UWorld* World = GameInstance->GetWorld();
+		GameInstance->Shutdown();
+		if (World)
+		{
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+		GameInstance->RemoveFromRoot();
+	}
+
+	IOnlineSessionPtr GetSessions(const UGameInstance* GameInstance)
+	{
+		return Online::GetSessionInterface(GameInstance->GetWorld());
+	}
+
+	UUT_SessionSubsystem* GetSessionSubsystem(const UGameInstance* GameInstance)
+	{
+		return GameInstance->GetSubsystem<UUT_SessionSubsystem>();
+	}
+
+	void Run(TFunction<void()> Action)
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Action]()
+		{
+			Action();
+			return true;
+		}));
+	}
+
+	// Waits while the engine ticks the online subsystems, fails the test after STEP_TIMEOUT
+	void WaitUntil(FAutomationTestBase* Test, const FString& What, TFunction<bool()> Condition)
+	{
+		const TSharedRef<double> StartTime = MakeShared<double>(-1.0);
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Test, What, Condition, StartTime]()
+		{
+			if (*StartTime < 0.0)
+			{
+				*StartTime = FPlatformTime::Seconds();
+			}
+
+			if (Condition())
+			{
+				return true;
+			}
+
+			if (FPlatformTime::Seconds() - *StartTime > STEP_TIMEOUT)
+			{
+				Test->AddError(FString::Printf(TEXT("Timed out waiting for %s"), *What));
+				return true;
+			}
+			return false;
+		}));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FUT_SessionSubsystemTest, "UnrealTest.Net.Sessions", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FUT_SessionSubsystemTest::RunTest(const FString& Parameters)
+{
+	using namespace UT_SessionTest;
+
+	const TSharedRef<FState> State = MakeShared<FState>();
+	State->Host = CreateGameInstance();
+	State->Client = CreateGameInstance();
+
+	if (!TestNotNull(TEXT("Host has the session subsystem"), GetSessionSubsystem(State->Host))
+		|| !TestNotNull(TEXT("Client has the session subsystem"), GetSessionSubsystem(State->Client))
+		|| !TestTrue(TEXT("Host and client use their own online subsystem"), GetSessions(State->Host) != GetSessions(State->Client)))
+	{
+		DestroyGameInstance(State->Host);
+		DestroyGameInstance(State->Client);
+		return false;
+	}
+
+	// Host without travelling
+	Run([State]()
+	{
+		GetSessionSubsystem(State->Host)->CreateSession(FString(), 4, true);
+	});
+	WaitUntil(this, TEXT("the hosted session"), [State]()
+	{
+		return GetSessions(State->Host)->GetNamedSession(NAME_GameSession) != nullptr;
+	});
+
+	// The second search replaces the first one while it is in flight and must still complete
+	Run([State]()
+	{
+		UUT_SessionSubsystem* Sessions = GetSessionSubsystem(State->Client);
+		Sessions->FindSessions(true, true);
+		Sessions->FindSessions(true, true);
+	});
+	WaitUntil(this, TEXT("the search results"), [State]()
+	{
+		const UUT_SessionSubsystem* Sessions = GetSessionSubsystem(State->Client);
+		return !Sessions->IsSearching() && Sessions->GetNumSessions() > 0;
+	});
+
+	Run([this, State]()
+	{
+		UUT_SessionSubsystem* Sessions = GetSessionSubsystem(State->Client);
+		TArray<FUT_SessionInfo> Page;
+		Sessions->GetSessionPage(0, Page);
+		if (TestTrue(TEXT("First page has the hosted session"), Page.Num() > 0))
+		{
+			TestEqual(TEXT("Hosted session has its open connections"), Page[0].NumOpenConnections, 4);
+			Sessions->JoinSession(Page[0].ResultIndex);
+		}
+	});
+	WaitUntil(this, TEXT("the joined session"), [State]()
+	{
+		return GetSessions(State->Client)->GetNamedSession(NAME_GameSession) != nullptr;
+	});
+
+	Run([State]()
+	{
+		DestroyGameInstance(State->Client);
+		DestroyGameInstance(State->Host);
+	});
+
+	return true;
+}
+
+#endif
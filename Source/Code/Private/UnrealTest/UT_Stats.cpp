@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnrealTest/UT_Stats.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_UT_ChoosePlayerStart);
+DEFINE_STAT(STAT_UT_ChooseTeam);
+DEFINE_STAT(STAT_UT_TeamChange);
+DEFINE_STAT(STAT_UT_TeamColors);
+DEFINE_STAT(STAT_UT_Interaction);
+DEFINE_STAT(STAT_UT_DoorToggle);
+DEFINE_STAT(STAT_UT_DoorAnimation);
+DEFINE_STAT(STAT_UT_Ragdoll);
+DEFINE_STAT(STAT_UT_Montage);
+DEFINE_STAT(STAT_UT_LagCompensation);
+DEFINE_STAT(STAT_UT_RewindTrace);
+DEFINE_STAT(STAT_UT_SpawnScoring);
+DEFINE_STAT(STAT_UT_Significance);
+
+DEFINE_STAT(STAT_UT_NumDoorToggles);
+DEFINE_STAT(STAT_UT_NumSpawns);
+DEFINE_STAT(STAT_UT_NumRagdollRpcs);
+DEFINE_STAT(STAT_UT_NumMovingDoors);
+DEFINE_STAT(STAT_UT_NumSimulatedRagdolls);
+
+CSV_DEFINE_CATEGORY_MODULE(UNREALTEST_API, UnrealTest, true);
+
+UE_TRACE_CHANNEL_DEFINE(UnrealTestChannel);
+
+DEFINE_LOG_CATEGORY(LogUnrealTest);
+
+uint32 FUT_MatchStats::Calls[static_cast<uint8>(EUT_MatchStat::Num)] = {};
+uint64 FUT_MatchStats::TotalCycles[static_cast<uint8>(EUT_MatchStat::Num)] = {};
+uint64 FUT_MatchStats::MaxCycles[static_cast<uint8>(EUT_MatchStat::Num)] = {};
+float FUT_MatchStats::StartTime = 0.f;
+
+static const TCHAR* MatchStatNames[] =
+{
+	TEXT("ChoosePlayerStart"),
+	TEXT("ChooseTeam"),
+	TEXT("TeamChange"),
+	TEXT("TeamColors"),
+	TEXT("Interaction"),
+	TEXT("DoorToggle"),
+	TEXT("DoorAnimation"),
+	TEXT("Ragdoll"),
+	TEXT("Montage"),
+	TEXT("LagCompensation"),
+	TEXT("RewindTrace"),
+	TEXT("SpawnScoring"),
+	TEXT("Significance"),
+};
+static_assert(UE_ARRAY_COUNT(MatchStatNames) == static_cast<uint8>(EUT_MatchStat::Num), "Every match stat needs a name");
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice MatchPerfSummaryCommand(
+	TEXT("ut.MatchPerfSummary"),
+	TEXT("Dumps the time spent in the gameplay code since the match started"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		FUT_MatchStats::Dump(Ar, World ? World->GetTimeSeconds() : 0.f);
+	}));
+
+void FUT_MatchStats::Add(EUT_MatchStat Stat, uint64 Cycles)
+{
+	const uint8 Index = static_cast<uint8>(Stat);
+	Calls[Index]++;
+	TotalCycles[Index] += Cycles;
+	MaxCycles[Index] = FMath::Max(MaxCycles[Index], Cycles);
+}
+
+void FUT_MatchStats::Reset(float MatchStartTime)
+{
+	FMemory::Memzero(Calls);
+	FMemory::Memzero(TotalCycles);
+	FMemory::Memzero(MaxCycles);
+	StartTime = MatchStartTime;
+}
+
+void FUT_MatchStats::Dump(FOutputDevice& Ar, float CurrentTime)
+{
+	Ar.Logf(TEXT("Match performance summary over %.1f seconds"), CurrentTime - StartTime);
+	Ar.Logf(TEXT("%-20s %10s %12s %12s %12s"), TEXT("Stat"), TEXT("Calls"), TEXT("Total ms"), TEXT("Avg us"), TEXT("Max us"));
+
+	for (uint8 Index = 0; Index < static_cast<uint8>(EUT_MatchStat::Num); Index++)
+	{
+		const double TotalMs = FPlatformTime::ToMilliseconds64(TotalCycles[Index]);
+		const double AverageUs = Calls[Index] > 0 ? TotalMs * 1000.0 / Calls[Index] : 0.0;
+		const double MaxUs = FPlatformTime::ToMilliseconds64(MaxCycles[Index]) * 1000.0;
+		Ar.Logf(TEXT("%-20s %10u %12.3f %12.3f %12.3f"), MatchStatNames[Index], Calls[Index], TotalMs, AverageUs, MaxUs);
+	}
+}
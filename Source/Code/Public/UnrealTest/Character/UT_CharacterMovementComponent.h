@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "UT_CharacterMovementComponent.generated.h"
+
+// Client move with coarser acceleration and location, the server only uses the location for error checks
+struct FUT_CharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+struct FUT_CharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FUT_CharacterNetworkMoveDataContainer();
+
+	FUT_CharacterNetworkMoveData MoveData[3];
+};
+
+/**
+ * Movement of the deathmatch characters.
+ * Clients send quantized move packets and hold moves identical to the last one longer so they get combined.
+ * Simulated proxies may be replicated at a lower rate by the replication graph when distant or out of view,
+ * smoothing stretches to the measured update interval to hide the gap.
+ */
+UCLASS()
+class UNREALTEST_API UUT_CharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UUT_CharacterMovementComponent();
+
+	// Rounds to whole units like the move packets
+	virtual FVector RoundAcceleration(FVector InAccel) const override;
+
+	virtual void SmoothCorrection(const FVector& OldLocation, const FQuat& OldRotation, const FVector& NewLocation, const FQuat& NewRotation) override;
+
+protected:
+	virtual float GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const override;
+
+private:
+	FUT_CharacterNetworkMoveDataContainer MoveDataContainer;
+
+	// Smoothing times set on the component, used at the full update rate
+	float DefaultSmoothLocationTime;
+	float DefaultSmoothRotationTime;
+
+	// World time of the last update received as a simulated proxy
+	float LastUpdateTime;
+
+	// Running average of the time between updates
+	float AverageUpdateInterval;
+
+	// Moves identical to the last one are sent at most this often
+	const float COMBINED_MOVE_DELTA_TIME = 1.f / 20.f;
+	// Weight of the newest interval in the average
+	const float UPDATE_INTERVAL_BLEND = 0.3f;
+	// Longest smoothing, larger gaps are teleports anyway
+	const float MAX_SMOOTH_LOCATION_TIME = 0.35f;
+};
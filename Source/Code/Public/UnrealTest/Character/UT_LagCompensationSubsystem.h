@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_LagCompensationSubsystem.generated.h"
+
+class AUnrealTestCharacter;
+
+// Hitboxes of one character in one recorded frame, a radius of 0 means no character was in the slot
+struct FUT_HitboxFrame
+{
+	FVector3f CapsuleCenter = FVector3f::ZeroVector;
+	FVector3f HeadCenter = FVector3f::ZeroVector;
+	float CapsuleHalfHeight = 0.f;
+	float CapsuleRadius = 0.f;
+
+	FORCEINLINE bool IsValid() const { return CapsuleRadius > 0.f; }
+};
+
+// Result of a rewound shot
+struct FUT_RewindHit
+{
+	AUnrealTestCharacter* Character = nullptr;
+	FVector Location = FVector::ZeroVector;
+	float Distance = 0.f;
+	bool bHeadshot = false;
+};
+
+/**
+ * Server history of character hitboxes for lag compensated hit validation.
+ * Every server frame the hitboxes of all registered characters are written in one pass to a fixed ring of frames,
+ * each frame being a contiguous row of MAX_CHARACTERS slots. Shots are tested against the rows around
+ * the shot time, the real actors are never moved.
+ */
+UCLASS()
+class UNREALTEST_API UUT_LagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Characters are recorded while registered, server only
+	void RegisterCharacter(AUnrealTestCharacter* Character);
+
+	void UnregisterCharacter(AUnrealTestCharacter* Character);
+
+	// Hitboxes of the character at the server time, interpolated between recorded frames
+	bool GetCharacterFrame(const AUnrealTestCharacter* Character, float Timestamp, FUT_HitboxFrame& OutFrame) const;
+
+	// Tests a shot against all characters as they were at the server time, nearest hit wins
+	bool RewindTrace(float Timestamp, const FVector& Start, const FVector& End, const AUnrealTestCharacter* IgnoreCharacter, FUT_RewindHit& OutHit) const;
+
+	// Characters per frame, enough for 64 players
+	static constexpr int32 MAX_CHARACTERS = 64;
+
+	// About two seconds at 60 frames per second, 64 * 128 frames of 32 bytes is 256 KB
+	static constexpr int32 MAX_FRAMES = 128;
+
+private:
+	void RecordFrame(float ServerTime);
+
+	// Frames recorded at or before and after Timestamp with the blend between them, false when nothing is recorded
+	bool FindFrames(float Timestamp, int32& OutOlderFrame, int32& OutNewerFrame, float& OutAlpha) const;
+
+	FUT_HitboxFrame BlendFrames(int32 OlderFrame, int32 NewerFrame, float Alpha, int32 Slot) const;
+
+	// MAX_FRAMES rows of MAX_CHARACTERS hitboxes
+	TArray<FUT_HitboxFrame> Frames;
+
+	// Server time of every row
+	TArray<float> FrameTimes;
+
+	// Row written last and number of rows written
+	int32 HeadFrame = INDEX_NONE;
+	int32 NumFrames = 0;
+
+	// Character of each slot, nullptr for free slots
+	UPROPERTY()
+	TArray<AUnrealTestCharacter*> Characters;
+
+	// Shots older than this are validated against the oldest allowed time
+	const float MAX_REWIND_TIME = 0.5f;
+	const float HEAD_RADIUS = 15.f;
+	const FName HEAD_SOCKET = TEXT("head");
+};
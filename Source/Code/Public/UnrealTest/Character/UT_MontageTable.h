@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "UT_MontageTable.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Montages a character can play over the network, they are sent by index in this table.
+ */
+UCLASS(BlueprintType)
+class UNREALTEST_API UUT_MontageTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Index of the montage, INDEX_NONE if it is not registered
+	int32 FindMontageIndex(const UAnimMontage* Montage) const;
+
+	UAnimMontage* GetMontage(int32 MontageIndex) const;
+
+	// Indices are sent as a byte
+	static constexpr int32 MAX_MONTAGES = 255;
+
+private:
+	UPROPERTY(EditDefaultsOnly, Category = "Animation", meta = (AllowPrivateAccess = "true"))
+	TArray<UAnimMontage*> Montages;
+};
@@ -19,6 +19,9 @@ public:
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	// Carries the team through seamless travel
+	virtual void CopyProperties(APlayerState* PlayerState) override;
+
 	// Updates Mesh Colors With the team id -- Red or Blue
 	void UpdateTeamColors() const;
 	
@@ -35,8 +38,8 @@ public:
 	// Team ID
 	UPROPERTY(ReplicatedUsing = OnRep_TeamNumberChanged)
 	int32 TeamNumber;
-	
-	// Times has died this pawn
-	UPROPERTY(Replicated)
-	int32 NumDeaths;
+
+	// Times has died this pawn, read from the scoreboard of the game state
+	UFUNCTION(BlueprintCallable)
+	int32 GetNumDeaths() const;
 };
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_RagdollSubsystem.generated.h"
+
+class AUnrealTestCharacter;
+
+/**
+ * Budget for cosmetic ragdolls on clients.
+ * Every body simulates for FALL_TIME so it ends up lying down, far, off-screen and over budget ones are frozen right after.
+ * Caps how many bodies simulate longer and freezes those as soon as they settle. Does nothing on dedicated servers.
+ */
+UCLASS()
+class UNREALTEST_API UUT_RagdollSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Simulates or freezes the character depending on budget, distance and visibility
+	void RequestRagdoll(AUnrealTestCharacter* Character);
+
+	// Forgets the character, it is being reattached to its capsule
+	void ReleaseRagdoll(AUnrealTestCharacter* Character);
+
+	FORCEINLINE int32 GetNumSimulatedRagdolls() const { return SimulatedCharacters.Num(); }
+
+private:
+	// Location of the local view, false if there is no local player
+	bool GetViewLocation(FVector& OutLocation) const;
+
+	void FreezeAt(int32 Index);
+
+	void RemoveAt(int32 Index);
+
+	UPROPERTY()
+	TArray<AUnrealTestCharacter*> SimulatedCharacters;
+
+	// World time the ragdoll at the same index started simulating
+	TArray<float> StartTimes;
+
+	// World time the ragdoll at the same index started being slow, negative while moving
+	TArray<float> SettleStartTimes;
+
+	// Ragdoll at the same index is frozen once FALL_TIME is over
+	TArray<bool> FallOnly;
+
+	// Fall only bodies go over the cap for at most FALL_TIME
+	const int32 MAX_SIMULATED_RAGDOLLS = 8;
+	// Shortest simulation of any body, enough to drop from standing to the ground
+	const float FALL_TIME = 1.f;
+	// Further away bodies only fall
+	const float MAX_SIMULATE_DISTANCE = 5000.f;
+	// Simulation time of a body next to the view, shrinks linearly to MIN at MAX_SIMULATE_DISTANCE
+	const float MAX_SIMULATE_TIME = 5.f;
+	const float MIN_SIMULATE_TIME = 1.f;
+	// Seconds since last render to consider a body visible
+	const float VISIBILITY_TIME = 0.5f;
+	// Body is settled after moving slower than SETTLE_SPEED for SETTLE_TIME
+	const float SETTLE_SPEED = 15.f;
+	const float SETTLE_TIME = 0.5f;
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_SignificanceSubsystem.generated.h"
+
+class AUnrealTestCharacter;
+
+// Cost level of a character on this client, from full cost to cheapest
+enum class EUT_Significance : uint8
+{
+	// Controlled by this client
+	Local,
+	High,
+	Medium,
+	Low,
+	// Not applied yet
+	None
+};
+
+/**
+ * Scales the client cost of characters by their significance to the local view.
+ * Characters are scored by distance, visibility and team every tick, the level of a character only
+ * changes its mesh, anim, movement and camera settings when the level changes. Only characters this client does not
+ * have authority over are registered, so listen servers keep full cost on the characters they simulate and record hitboxes for.
+ */
+UCLASS()
+class UNREALTEST_API UUT_SignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(AUnrealTestCharacter* Character);
+
+	void UnregisterCharacter(AUnrealTestCharacter* Character);
+
+private:
+	// 1 for a visible enemy next to the view down to 0 for anything past MAX_SIGNIFICANCE_DISTANCE
+	float GetSignificance(const AUnrealTestCharacter* Character, const FVector& ViewLocation, int32 LocalTeamNum) const;
+
+	void ApplySignificance(AUnrealTestCharacter* Character, EUT_Significance Significance, int32 Index) const;
+
+	void RemoveAt(int32 Index);
+
+	UPROPERTY()
+	TArray<AUnrealTestCharacter*> Characters;
+
+	// Level applied to the character at the same index
+	TArray<EUT_Significance> Significances;
+
+	// Overlap generation of the mesh before it was ever turned off
+	TArray<bool> DefaultMeshOverlaps;
+
+	// Anim tick option of the mesh before it was ever changed
+	TArray<EVisibilityBasedAnimTickOption> DefaultAnimTickOptions;
+
+	const float MAX_SIGNIFICANCE_DISTANCE = 6000.f;
+	// Seconds since last render to consider a character visible
+	const float VISIBILITY_TIME = 0.25f;
+	// Significance kept by characters off screen and by teammates
+	const float HIDDEN_SCALE = 0.25f;
+	const float TEAMMATE_SCALE = 0.75f;
+	// Lowest significance of each level
+	const float HIGH_SIGNIFICANCE = 0.6f;
+	const float MEDIUM_SIGNIFICANCE = 0.25f;
+	// Tick intervals of the mesh, which drives the anim instance, and of the movement component
+	const float MEDIUM_TICK_INTERVAL = 1.f / 30.f;
+	const float LOW_TICK_INTERVAL = 1.f / 10.f;
+};
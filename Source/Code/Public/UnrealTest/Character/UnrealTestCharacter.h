@@ -7,14 +7,40 @@
 #include "UnrealTestCharacter.generated.h"
 
 class ADoor;
+class UUT_MontageTable;
+
+// Montage currently played by a character, lets late joiners catch up without reliable replays
+USTRUCT()
+struct FUT_MontageState
+{
+	GENERATED_BODY()
+
+	// Index in the montage table of the character, NONE_MONTAGE if nothing is playing
+	UPROPERTY()
+	uint8 MontageIndex = NONE_MONTAGE;
+
+	// Server time the montage started, quantized with FUT_NetTime
+	UPROPERTY()
+	uint16 StartTime = 0;
+
+	static constexpr uint8 NONE_MONTAGE = 0xFF;
+
+	bool operator==(const FUT_MontageState& Other) const
+	{
+		return MontageIndex == Other.MontageIndex && StartTime == Other.StartTime;
+	}
+};
 
 UCLASS(config=Game)
 class AUnrealTestCharacter : public ACharacter
 {
 	GENERATED_BODY()
 
+	// Load test bots drive the server RPCs directly
+	friend class UUT_LoadTestBotSubsystem;
+
 public:
-	AUnrealTestCharacter();
+	AUnrealTestCharacter(const FObjectInitializer& ObjectInitializer);
 
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
@@ -36,10 +62,14 @@ public:
 
 	void ActionBinding(class UInputComponent* PlayerInputComponent);
 	
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_PlayAnimation(UAnimMontage* MontageToPlay);
-	void Multicast_PlayAnimation_Implementation(UAnimMontage* MontageToPlay);
-	
+	// Plays a montage of MontageTable on every relevant machine, authority only
+	UFUNCTION(BlueprintCallable)
+	void PlayAnimation(UAnimMontage* MontageToPlay);
+
+	// Montage is sent as its index in MontageTable, clients that miss it catch up through CurrentMontage
+	UFUNCTION(NetMulticast, Unreliable)
+	void Multicast_PlayAnimation(uint8 MontageIndex, uint16 StartTime);
+	void Multicast_PlayAnimation_Implementation(uint8 MontageIndex, uint16 StartTime);
 	
 	/** */
 	//TEAM
@@ -47,19 +77,41 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, BlueprintCallable)
 	void UpdateTeamColors(int32 TeamColor);
 
+	// Applies the shared team materials, only when the team changed. Falls back to UpdateTeamColors for teams without materials
+	void ApplyTeamColors(int32 TeamNum);
+
 	int32 GetPlayerTeam() const;
 
+	/** */
+	//RAGDOLL
+	// Driven by UUT_RagdollSubsystem
+	void StartRagdollSimulation();
+
+	// Stops simulating and keeps the current pose
+	void FreezeRagdollPose();
+
+	//PAWN POOL
+	// Stops and hides the dead character until the game mode reuses it, server only, clients follow through bIsParked
+	void ParkInPool();
+
+	// Brings the parked character back to life at the spawn transform, server only
+	void ReuseFromPool(const FTransform& SpawnTransform);
+
+	FORCEINLINE bool IsParked() const { return bIsParked; }
+
 protected:
+	// Turns the camera off on dedicated servers
+	virtual void PostInitializeComponents() override;
+
+	// Registers for lag compensation on the server
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void PossessedBy(class AController* C) override;
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
-	UFUNCTION()
-	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	UFUNCTION()
-	void OnOverlapEnd(class UPrimitiveComponent* OverlappedComp, class AActor* OtherActor, class UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-	
 	virtual void OnRep_PlayerState() override;
 
 	/** Called for forwards/backward input */
@@ -87,10 +139,38 @@ protected:
 	void TouchStopped(ETouchIndex::Type FingerIndex, FVector Location);
 
 	void OnAction();
+
+	// Door the pawn can use from where it stands and looks
+	ADoor* FindInteractionDoor() const;
 	
 	UFUNCTION(Server, Reliable, WithValidation)
 	void Server_OnAction();
 
+	UFUNCTION()
+	void OnRep_CurrentMontage();
+
+	UFUNCTION()
+	void OnRep_IsParked();
+
+	// Movement, collision and visibility of bIsParked, applied on the server and on clients
+	void ApplyParkedState();
+
+	// Back to NONE_MONTAGE once the montage is over, server only
+	void ClearCurrentMontage();
+
+	// Plays montage state unless it was already played here
+	void PlayMontageState(const FUT_MontageState& MontageState);
+
+	// Cosmetics are compiled out of server builds and skipped by dedicated servers running a game build
+	FORCEINLINE bool ShouldSkipCosmetics() const
+	{
+#if UE_SERVER
+		return true;
+#else
+		return GetNetMode() == NM_DedicatedServer;
+#endif
+	}
+
 private:
 	/** */
 	// Functions tp Enable/Disable Capsule collision
@@ -128,9 +208,28 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera", meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
 
-	UPROPERTY(Replicated)
-	ADoor* CurrentDoor;
-	
+	// Team whose colors are on the mesh
+	int32 AppliedTeamColor;
+
+	// Waiting in the pawn pool of the game mode
+	UPROPERTY(ReplicatedUsing = OnRep_IsParked)
+	bool bIsParked;
+
+	// Puts the streamed in materials of the team on the mesh
+	void SetTeamMaterials(int32 TeamNum);
+
+	/** Montages that can be played over the network */
+	UPROPERTY(EditDefaultsOnly, Category = "Animation", meta = (AllowPrivateAccess = "true"))
+	UUT_MontageTable* MontageTable;
+
+	UPROPERTY(ReplicatedUsing = OnRep_CurrentMontage)
+	FUT_MontageState CurrentMontage;
+
+	// Last montage state played on this machine
+	FUT_MontageState PlayedMontage;
+
+	FTimerHandle MontageEndTimer;
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Input, meta = (AllowPrivateAccess = "true"))
 	float TurnRateGamepad;
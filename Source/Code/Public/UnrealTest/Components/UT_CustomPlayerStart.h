@@ -19,6 +19,16 @@ public:
 
 	FORCEINLINE int32 GetSpawnTeam() const { return SpawnTeam; }
 
+	// Only takes effect before BeginPlay registers the start
+	FORCEINLINE void SetSpawnTeam(int32 NewSpawnTeam) { SpawnTeam = NewSpawnTeam; }
+
+protected:
+	// Registers in the spawn point subsystem
+	virtual void BeginPlay() override;
+
+	// Unregisters from the spawn point subsystem
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 	UPROPERTY(EditAnywhere, Category = "Team", meta = (AllowPrivateAccess = "true"))
 	int32 SpawnTeam;
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetManager.h"
+#include "UT_AssetManager.generated.h"
+
+/**
+ * Asset manager of the project, set as AssetManagerClassName in DefaultEngine.ini.
+ * Cooks the bundles of the UUT_GameplayAssets class defaults while no data asset is authored, nothing else references them.
+ */
+UCLASS()
+class UNREALTEST_API UUT_AssetManager : public UAssetManager
+{
+	GENERATED_BODY()
+
+public:
+#if WITH_EDITOR
+	virtual void ModifyCook(TConstArrayView<const ITargetPlatform*> TargetPlatforms, TArray<FName>& PackagesToCook, TArray<FName>& PackagesToNeverCook) override;
+#endif
+};
@@ -7,7 +7,7 @@
 #include "UT_DeathMatchGameMode.generated.h"
 
 class AUT_PlayerState;
-class APlayerStart;
+class AUnrealTestCharacter;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnMatchStart);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnMatchEnd);
@@ -19,15 +19,48 @@ class UNREALTEST_API AUT_DeathMatchGameMode : public AGameMode
 {
 	GENERATED_BODY()
 
+	// Benchmarks the team selection directly
+	friend class FUT_ChooseTeamBenchmark;
+
 public:
 	AUT_DeathMatchGameMode(const FObjectInitializer& ObjectInitializer);
+
+	// Updates the scoreboard when a player is killed, only counted while the match is in progress
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void ScoreKill(AController* Killer, AController* Victim);
+
+	// Unpossesses the dead character and parks it for the next respawn, destroys it when the pool is full
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly)
+	void ReleasePawn(AUnrealTestCharacter* Character);
 	
 protected:
 	// PROPERTIES 
+	// Players needed to leave warmup and start the countdown
 	UPROPERTY(EditDefaultsOnly, Category = "Config")
 	int32 PlayerNumberToStartGame;
+
+	// Seconds between reaching the player threshold and the start of the match
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	float CountdownTime;
+
+	// Seconds a match lasts, 0 for no limit
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	float MatchTime;
+
+	// Seconds the scores stay up before traveling to the next map
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	float PostMatchTime;
+
+	// Dead characters kept for respawns
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	int32 MaxPooledPawns;
+
+	// Maps played in order after each match, empty to replay the current map
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
+	TArray<TSoftObjectPtr<UWorld>> MapRotation;
 	
 	//Number of teams
+	UPROPERTY(EditDefaultsOnly, Category = "Config")
 	int32 NumTeams;
 
 	UPROPERTY(BlueprintAssignable)
@@ -36,16 +69,60 @@ protected:
 	UPROPERTY(BlueprintAssignable)
 	FOnMatchEnd OnMatchEnd;
 
+	// Pushes team setup to the game state
+	virtual void InitGameState() override;
+
+	// Assigns team on login
+	virtual FString InitNewPlayer(APlayerController* NewPlayerController, const FUniqueNetIdRepl& UniqueId, const FString& Options, const FString& Portal = TEXT("")) override;
+
+	// Removes player from its team
+	virtual void Logout(AController* Exiting) override;
+
 	// Select best spawn point for player
 	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
 
-	// Checks Player State team in spawning point 
-	virtual bool CheckStartTeam(APlayerStart* PlayerStart, AController* Player) const;
+	// Reuses a parked character before spawning a new one
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+	// Countdown does not count as started
+	virtual bool HasMatchStarted() const override;
+
+	// Times the countdown, match and post match states
+	virtual void OnMatchStateSet() override;
+
+	// Respawns everyone at their team starts and starts the performance summary of the match
+	virtual void HandleMatchHasStarted() override;
+
+	// Logs the performance summary of the match and schedules the travel to the next map
+	virtual void HandleMatchHasEnded() override;
+
+	// Players can run around during warmup and countdown
+	virtual bool PlayerCanRestart_Implementation(APlayerController* Player) override;
 
 	// New player joins
 	virtual void HandleStartingNewPlayer_Implementation(APlayerController* NewPlayer) override;
+
+	// Keeps the team the player had in the previous map
+	virtual void InitSeamlessTravelPlayer(AController* NewController) override;
+
+	// Player arrives from the previous map
+	virtual void HandleSeamlessTravelPlayer(AController*& C) override;
+
+	// Moves between warmup and countdown as players come and go
+	void CheckPlayerThreshold();
+
+	// Seamless travel to the next map of the rotation
+	void TravelToNextMap();
 	
 	//TEAM FUNCTION
-	//Picks team random or where there are the least Players
+	//Picks team where there are the least Players
 	int32 ChooseTeam(AUT_PlayerState* PlayerState) const;
+
+private:
+	// Ends the current timed match state
+	FTimerHandle MatchStateTimer;
+
+	// Parked characters, see ReleasePawn
+	UPROPERTY()
+	TArray<AUnrealTestCharacter*> PawnPool;
 };
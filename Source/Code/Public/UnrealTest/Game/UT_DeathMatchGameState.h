@@ -4,8 +4,22 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+
+#include "UnrealTest/Game/UT_Scoreboard.h"
+
 #include "UT_DeathMatchGameState.generated.h"
 
+// Match states added on top of the ones of AGameMode, warmup is MatchState::WaitingToStart
+namespace UT_MatchState
+{
+	// Enough players joined, the match starts when the countdown ends
+	extern UNREALTEST_API const FName Countdown;
+}
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMatchStateChanged, FName, NewMatchState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnScoreboardChanged, APlayerState*, PlayerState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnTeamScoresChanged);
+
 /**
  * 
  */
@@ -19,8 +33,86 @@ public:
 
 	virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
 
+	// Sets number of teams and resets team counters
+	void SetNumTeams(int32 NewNumTeams);
+
+	FORCEINLINE int32 GetNumTeams() const { return NumTeams; }
+
+	// Moves one player between team counters, INDEX_NONE means no team
+	void UpdateTeamCount(int32 OldTeam, int32 NewTeam);
+
+	// Number of players in team, server only
+	int32 GetTeamPlayerCount(int32 Team) const;
+
+	// Returns the index of the team least populated, server only
+	int32 GetSmallestTeam() const;
+
+	// Countdown does not count as started
+	virtual bool HasMatchStarted() const override;
+
+	// Server time at which the current match state ends, 0 if it has no time limit
+	void SetMatchStateEndTime(float NewMatchStateEndTime);
+
+	// Seconds left in the current match state
+	UFUNCTION(BlueprintCallable)
+	float GetMatchStateTimeRemaining() const;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnMatchStateChanged OnMatchStateChanged;
+
+	// SCOREBOARD
+	// Puts players on the scoreboard as they join, server only
+	virtual void AddPlayerState(APlayerState* PlayerState) override;
+
+	virtual void RemovePlayerState(APlayerState* PlayerState) override;
+
+	// Credits the kill to the killer and its team and the death to the victim, server only
+	void ScoreKill(APlayerState* Killer, APlayerState* Victim);
+
+	// Zeroes player and team scores, server only
+	void ResetScores();
+
+	UFUNCTION(BlueprintCallable)
+	const TArray<FUT_ScoreboardEntry>& GetScoreboardEntries() const;
+
+	// False if the player is not on the scoreboard
+	UFUNCTION(BlueprintCallable)
+	bool GetPlayerScore(const APlayerState* PlayerState, int32& OutKills, int32& OutDeaths, int32& OutScore) const;
+
+	UFUNCTION(BlueprintCallable)
+	int32 GetTeamScore(int32 Team) const;
+
+	// A row was added, changed or removed, player state is null when every row changed
+	UPROPERTY(BlueprintAssignable)
+	FOnScoreboardChanged OnScoreboardChanged;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnTeamScoresChanged OnTeamScoresChanged;
+
+	// Score for a kill
+	static constexpr int32 KILL_SCORE = 1;
+
+protected:
+	virtual void OnRep_MatchState() override;
+
+	UFUNCTION()
+	void OnRep_TeamScores();
+
 private:
 	// Number of teams in current game
 	UPROPERTY(Replicated)
 	int32 NumTeams;
+
+	UPROPERTY(Replicated)
+	float MatchStateEndTime;
+
+	// Only changed rows are sent
+	UPROPERTY(Replicated)
+	FUT_Scoreboard Scoreboard;
+
+	UPROPERTY(ReplicatedUsing = OnRep_TeamScores)
+	TArray<int32> TeamScores;
+
+	// Live number of players per team, kept by the server
+	TArray<int32> TeamPlayerCounts;
 };
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "UT_GameplayAssets.generated.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+
+// Materials of one team, index is the material slot of the character mesh
+USTRUCT()
+struct FUT_TeamMaterials
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, Category = "Team", meta = (AssetBundles = "Cosmetic"))
+	TArray<TSoftObjectPtr<UMaterialInterface>> Materials;
+};
+
+/**
+ * Gameplay assets referenced softly and streamed in bundles by UUT_GameplayAssetsSubsystem.
+ * The Gameplay bundle is loaded everywhere, the Cosmetic bundle is skipped on dedicated servers.
+ * Class defaults are used until a data asset of this class is authored under /Game/ThirdPerson/Data.
+ */
+UCLASS(BlueprintType)
+class UNREALTEST_API UUT_GameplayAssets : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UUT_GameplayAssets();
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	// Paths in the bundles, for the class defaults that have no bundle data in the asset manager
+	void GetBundlePaths(const TArray<FName>& Bundles, TArray<FSoftObjectPath>& OutPaths) const;
+
+	// Door panel, it also gives doors their collision so servers load it too
+	UPROPERTY(EditDefaultsOnly, Category = "Door", meta = (AssetBundles = "Gameplay"))
+	TSoftObjectPtr<UStaticMesh> DoorMesh;
+
+	/** Shared material instances per team, index is the team number */
+	UPROPERTY(EditDefaultsOnly, Category = "Team")
+	TArray<FUT_TeamMaterials> TeamMaterials;
+
+	static const FPrimaryAssetType PRIMARY_ASSET_TYPE;
+	static const FName GAMEPLAY_BUNDLE;
+	static const FName COSMETIC_BUNDLE;
+};
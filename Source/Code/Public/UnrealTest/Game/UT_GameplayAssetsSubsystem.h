@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UT_GameplayAssetsSubsystem.generated.h"
+
+class UUT_GameplayAssets;
+struct FStreamableHandle;
+
+/**
+ * Streams the gameplay asset bundles in when the game instance starts, so they load alongside the first map.
+ * Keeps them loaded for the lifetime of the game instance, across map changes.
+ */
+UCLASS()
+class UNREALTEST_API UUT_GameplayAssetsSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Authored data asset once loaded, class defaults otherwise
+	const UUT_GameplayAssets* GetGameplayAssets() const;
+
+	// Also works in worlds without a game instance
+	static const UUT_GameplayAssets* FindGameplayAssets(const UWorld* World);
+
+private:
+	FPrimaryAssetId GameplayAssetsId;
+
+	TSharedPtr<FStreamableHandle> LoadHandle;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_InteractionSubsystem.generated.h"
+
+class ADoor;
+
+// Interactables whose location falls in one cell of the spatial hash
+USTRUCT()
+struct FUT_InteractionCell
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<ADoor*> Doors;
+};
+
+/**
+ * Keeps interactables in a 2D spatial hash so pawns can query them on demand
+ * instead of tracking them through overlap events.
+ */
+UCLASS()
+class UNREALTEST_API UUT_InteractionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Adds door to the cell of its location, doors are not expected to move
+	void RegisterDoor(ADoor* Door);
+
+	void UnregisterDoor(ADoor* Door);
+
+	// Nearest door in range that lies in front of Facing, nullptr if there is none
+	ADoor* FindBestDoor(const FVector& Location, const FVector& Facing) const;
+
+private:
+	FIntPoint GetCell(const FVector& Location) const;
+
+	UPROPERTY()
+	TMap<FIntPoint, FUT_InteractionCell> Cells;
+
+	const float CELL_SIZE = 500.f;
+	const float INTERACTION_DISTANCE = 250.f;
+	// Minimum cosine between facing and the direction to the door
+	const float MIN_FACING_DOT = 0.f;
+};
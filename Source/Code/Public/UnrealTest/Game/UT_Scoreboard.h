@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "UT_Scoreboard.generated.h"
+
+class APlayerState;
+class AUT_DeathMatchGameState;
+struct FUT_Scoreboard;
+
+// Scoreboard row of one player
+USTRUCT(BlueprintType)
+struct UNREALTEST_API FUT_ScoreboardEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	APlayerState* PlayerState = nullptr;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Kills = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Deaths = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Score = 0;
+
+	// Client callbacks, forwarded to the HUD through the game state
+	void PostReplicatedAdd(const FUT_Scoreboard& InArraySerializer);
+	void PostReplicatedChange(const FUT_Scoreboard& InArraySerializer);
+	void PreReplicatedRemove(const FUT_Scoreboard& InArraySerializer);
+};
+
+/**
+ * Per player kills, deaths and score, delta replicated so only changed rows are sent.
+ * Only the server edits it, every edit marks its row dirty.
+ */
+USTRUCT()
+struct UNREALTEST_API FUT_Scoreboard : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FUT_ScoreboardEntry, FUT_Scoreboard>(Entries, DeltaParms, *this);
+	}
+
+	void AddPlayer(APlayerState* PlayerState);
+
+	void RemovePlayer(const APlayerState* PlayerState);
+
+	// Adds to the counters of the player, no-op for players not on the scoreboard
+	void AddStats(const APlayerState* PlayerState, int32 Kills, int32 Deaths, int32 Score);
+
+	// Zeroes every row, players stay on the scoreboard
+	void ResetStats();
+
+	const FUT_ScoreboardEntry* FindEntry(const APlayerState* PlayerState) const;
+
+	FORCEINLINE const TArray<FUT_ScoreboardEntry>& GetEntries() const { return Entries; }
+
+	// Receives the change callbacks, not replicated
+	UPROPERTY(NotReplicated)
+	AUT_DeathMatchGameState* Owner = nullptr;
+
+private:
+	UPROPERTY()
+	TArray<FUT_ScoreboardEntry> Entries;
+};
+
+template<>
+struct TStructOpsTypeTraits<FUT_Scoreboard> : public TStructOpsTypeTraitsBase2<FUT_Scoreboard>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
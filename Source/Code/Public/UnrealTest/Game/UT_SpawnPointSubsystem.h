@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "UT_SpawnPointSubsystem.generated.h"
+
+class AUT_CustomPlayerStart;
+
+// Line of sight trace from an enemy to a start, answered on the next tick
+struct FUT_SpawnTrace
+{
+	FTraceHandle Handle;
+	int32 StartIndex = INDEX_NONE;
+};
+
+// Spawn points of a single team, LastUsedTimes and StartLocations are kept parallel to Starts
+USTRUCT()
+struct FUT_SpawnTeamBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AUT_CustomPlayerStart*> Starts;
+
+	TArray<float> LastUsedTimes;
+
+	// Start indices from the safest to the least safe, empty until the first scoring
+	TArray<int32> Ranking;
+
+	// World time Ranking was scored
+	float RankingTime = -1.f;
+
+	// Snapshot the traces in flight were issued with
+	TArray<FVector> StartLocations;
+	TArray<FVector> EnemyLocations;
+	TArray<FUT_SpawnTrace> PendingTraces;
+	bool bTracesInFlight = false;
+};
+
+/**
+ * Registry of custom player starts bucketed by team.
+ * Starts register themselves on BeginPlay/EndPlay so the game mode never has to iterate the world.
+ * On the server the starts of each team are ranked by enemy distance and line of sight every RANKING_LIFETIME,
+ * the visibility traces are async so claiming a start only reads the last ranking.
+ */
+UCLASS()
+class UNREALTEST_API UUT_SpawnPointSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Adds start to the bucket of its spawn team
+	void RegisterStart(AUT_CustomPlayerStart* PlayerStart);
+
+	// Removes start from the bucket of its spawn team
+	void UnregisterStart(AUT_CustomPlayerStart* PlayerStart);
+
+	// Picks the safest start of the team that was not used recently and marks it as used, random until the team is ranked
+	AUT_CustomPlayerStart* ClaimStart(int32 TeamNum);
+
+	// All starts registered for the team
+	const TArray<AUT_CustomPlayerStart*>& GetTeamStarts(int32 TeamNum) const;
+
+private:
+	// Starts a scoring of the bucket, traces from every enemy in range to every start
+	void IssueTraces(int32 TeamNum, FUT_SpawnTeamBucket& Bucket) const;
+
+	// Reads the traces issued last tick and ranks the starts in parallel
+	void RankStarts(FUT_SpawnTeamBucket& Bucket) const;
+
+	// Start indices changed, drops the ranking and any traces in flight
+	static void ResetRanking(FUT_SpawnTeamBucket& Bucket);
+
+	UPROPERTY()
+	TMap<int32, FUT_SpawnTeamBucket> TeamBuckets;
+
+	// Seconds a start stays blocked after being claimed
+	const float RECENT_USE_WINDOW = 2.f;
+	// Seconds a team ranking is used before scoring again
+	const float RANKING_LIFETIME = 0.5f;
+	// Enemies further away than SAFE_DISTANCE do not lower the score
+	const float SAFE_DISTANCE = 5000.f;
+	// Enemies further away than MAX_VISIBILITY_DISTANCE are not traced
+	const float MAX_VISIBILITY_DISTANCE = 8000.f;
+	// Score lost for every enemy with line of sight to the start
+	const float VISIBLE_ENEMY_PENALTY = 2500.f;
+	// Traces aim at the head of a character standing on the start
+	const FVector EYE_OFFSET = FVector(0.f, 0.f, 60.f);
+};
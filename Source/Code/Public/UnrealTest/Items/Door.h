@@ -7,6 +7,54 @@
 #include "GameFramework/Actor.h"
 #include "Door.generated.h"
 
+/**
+ * Replicated state of a door, everything else is rebuilt by clients.
+ * Serialized as 3 bits of flags and a 16 bit timestamp.
+ */
+USTRUCT()
+struct UNREALTEST_API FDoorState
+{
+	GENERATED_BODY()
+
+	// Door is open or is opening
+	UPROPERTY()
+	bool bIsOpen = false;
+
+	// Side the door opens to, 1 or -1
+	UPROPERTY()
+	int8 Direction = 1;
+
+	// Server time of the last toggle, quantized with FUT_NetTime
+	UPROPERTY()
+	uint16 ToggleTime = 0;
+
+	// Motion is over, the door is at rest whatever the wrapped ToggleTime says
+	UPROPERTY()
+	bool bSettled = false;
+
+	// Seconds since the last toggle
+	float GetElapsedTime(float ServerTime) const;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FDoorState& Other) const
+	{
+		return bIsOpen == Other.bIsOpen && Direction == Other.Direction && ToggleTime == Other.ToggleTime && bSettled == Other.bSettled;
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FDoorState> : public TStructOpsTypeTraitsBase2<FDoorState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true,
+	};
+};
+
+class UHierarchicalInstancedStaticMeshComponent;
+
 UCLASS()
 class UNREALTEST_API ADoor : public AActor
 {
@@ -15,27 +63,53 @@ class UNREALTEST_API ADoor : public AActor
 public:	
 	// Sets default values for this actor's properties
 	ADoor();
-	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
 
 	UFUNCTION()
 	void ToggleDoor(FVector ForwardVector);
 
-	UFUNCTION()
-	void OpenDoor(const float DeltaTime);
+	// Door yaw at the given server time, rebuilt from the replicated state
+	static float GetDoorYaw(const FDoorState& State, float ServerTime);
+
+	// True until the door reaches its end rotation
+	static bool IsDoorMoving(const FDoorState& State, float ServerTime);
+
+	// Yaw of a door that is not moving
+	static float GetDoorRestYaw(const FDoorState& State);
+
+	FORCEINLINE UStaticMeshComponent* GetDoorMesh() const { return DoorMesh; }
+	FORCEINLINE UHierarchicalInstancedStaticMeshComponent* GetDoorInstances() const { return DoorInstances; }
+	FORCEINLINE int32 GetDoorInstanceIndex() const { return DoorInstanceIndex; }
+	FORCEINLINE const FDoorState& GetDoorState() const { return DoorState; }
+
+	// World transform of the door instance opened at Yaw
+	FTransform GetDoorInstanceTransform(float Yaw) const;
 
-	UFUNCTION()
-	void CloseDoor(const float DeltaTime);
-	
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 protected:
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+#if WITH_EDITOR
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+#endif
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	
+	// Hands the door to the animation subsystem
 	UFUNCTION()
-	void OnRep_DoorToggled();
+	void OnRep_DoorState();
+
+	// DoorMeshAsset or the door mesh of the gameplay assets
+	TSoftObjectPtr<UStaticMesh> GetDoorMeshAsset() const;
+
+	// Marks the motion over so clients receiving the state later do not replay it
+	void SettleDoor();
+
+	// Sets the streamed in mesh and moves the door to the instanced field if enabled
+	void OnDoorMeshLoaded(TSoftObjectPtr<UStaticMesh> MeshAsset);
 	
 private:
 	UPROPERTY(EditAnywhere, Category = "Door", meta = (AllowPrivateAccess = "true"))
@@ -44,30 +118,29 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Door", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* DoorMesh;
 
-	UPROPERTY(ReplicatedUsing = OnRep_DoorToggled)
-	bool bIsDoorOpened;
+	// Overrides the door mesh of the gameplay assets
+	UPROPERTY(EditAnywhere, Category = "Door", meta = (AllowPrivateAccess = "true"))
+	TSoftObjectPtr<UStaticMesh> DoorMeshAsset;
+
+	// Render through the shared door field instead of an own mesh component
+	UPROPERTY(EditAnywhere, Category = "Door", meta = (AllowPrivateAccess = "true"))
+	bool bUseInstancedMesh;
 
-	UPROPERTY(Replicated)
-	bool bIsDoorOpening;
-	
-	UPROPERTY(Replicated)
-	bool bIsDoorClosing;
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* DoorInstances;
 
-	UPROPERTY(Replicated)
-	float DotProduct;
-	
-	UPROPERTY(Replicated)
-	float MaxDegree;
-	
-	UPROPERTY(Replicated)
-	float AddRotation;
-	
-	UPROPERTY(Replicated)
-	float PositiveNegative;
-	
-	UPROPERTY(Replicated)
-	float DoorCurrentRotation;
+	int32 DoorInstanceIndex;
+
+	// Mesh transform relative to the actor, rotation excluded
+	FTransform DoorMeshRestTransform;
+
+	UPROPERTY(ReplicatedUsing = OnRep_DoorState)
+	FDoorState DoorState;
+
+	FTimerHandle SettleTimer;
 
-	UPROPERTY(Replicated)
-	FVector DoorForwardVector;
+	static constexpr float MAX_DEGREE = 90.f;
+	static constexpr float ROTATION_SPEED = 80.f;
+	// Time the door stays awake after its motion so the settled state gets out before dormancy
+	static constexpr float SETTLE_MARGIN = 0.5f;
 };
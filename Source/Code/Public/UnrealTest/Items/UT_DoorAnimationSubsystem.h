@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UnrealTest/Items/Door.h"
+#include "UT_DoorAnimationSubsystem.generated.h"
+
+/**
+ * Animates all moving doors of the world in one batched update per frame.
+ * Doors are kept as structure of arrays and only while they move, idle doors cost nothing.
+ */
+UCLASS()
+class UNREALTEST_API UUT_DoorAnimationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Starts or restarts moving the door from its current state
+	void AddMovingDoor(ADoor* Door, const FDoorState& DoorState);
+
+	// Stops moving the door, it keeps its current rotation
+	void RemoveMovingDoor(ADoor* Door);
+
+	bool IsDoorMoving(const ADoor* Door) const;
+
+	FORCEINLINE int32 GetNumMovingDoors() const { return Doors.Num(); }
+
+private:
+	// Writes the yaw at ServerTime to the door at Index, returns true if it reached its end
+	bool UpdateDoor(int32 Index, float ServerTime);
+
+	void RemoveAtSwap(int32 Index);
+
+	// Structure of arrays, same index in every array is the same door
+	UPROPERTY()
+	TArray<ADoor*> Doors;
+
+	// Null for doors rendered through the door field
+	UPROPERTY()
+	TArray<UStaticMeshComponent*> DoorMeshes;
+
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> DoorInstances;
+
+	TArray<int32> DoorInstanceIndices;
+
+	TArray<FDoorState> DoorStates;
+
+	// Door fields touched this frame, render state is dirtied once per field
+	UPROPERTY()
+	TArray<UHierarchicalInstancedStaticMeshComponent*> DirtyDoorInstances;
+};
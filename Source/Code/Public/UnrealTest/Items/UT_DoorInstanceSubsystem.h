@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_DoorInstanceSubsystem.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+
+// Instances of one door mesh, FreeIndices are hidden instances ready to be reused
+USTRUCT()
+struct FUT_DoorInstanceField
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* Instances = nullptr;
+
+	TArray<int32> FreeIndices;
+};
+
+/**
+ * Renders every instanced door sharing a mesh through one hierarchical instanced static mesh component.
+ * Components live on a transient local actor, nothing here is replicated.
+ */
+UCLASS()
+class UNREALTEST_API UUT_DoorInstanceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Adds an instance of the mesh, returns its index in OutInstances
+	int32 AddDoorInstance(UStaticMesh* DoorMesh, const FTransform& WorldTransform, UHierarchicalInstancedStaticMeshComponent*& OutInstances);
+
+	// Hides the instance and keeps its index for the next door, indices of other doors stay stable
+	void RemoveDoorInstance(UHierarchicalInstancedStaticMeshComponent* Instances, int32 InstanceIndex);
+
+private:
+	UHierarchicalInstancedStaticMeshComponent* FindOrCreateField(UStaticMesh* DoorMesh);
+
+	UPROPERTY()
+	AActor* FieldActor;
+
+	UPROPERTY()
+	TMap<UStaticMesh*, FUT_DoorInstanceField> Fields;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_LoadTestBotSubsystem.generated.h"
+
+/**
+ * Client side of the load test, only created with -loadtestbot.
+ * Drives the local pawn with random movement and spams the action RPC at the server.
+ */
+UCLASS()
+class UNREALTEST_API UUT_LoadTestBotSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+private:
+	FVector MoveDirection = FVector::ForwardVector;
+
+	float NextDirectionTime = 0.f;
+	float NextActionTime = 0.f;
+
+	const float DIRECTION_INTERVAL = 2.f;
+	const float ACTION_INTERVAL = 0.5f;
+	const float JUMP_CHANCE = 0.01f;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "UT_LoadTestCommandlet.generated.h"
+
+/**
+ * Starts a headless dedicated server on loopback and N bot clients, then waits for the report.
+ * UnrealEditor-Cmd UnrealTest.uproject -run=UT_LoadTest -clients=16 -duration=120 -map=ThirdPersonMap -port=7777
+ */
+UCLASS()
+class UNREALTEST_API UUT_LoadTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UUT_LoadTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	FProcHandle LaunchInstance(const FString& Arguments) const;
+
+	// Time given to the server to boot before clients connect
+	const float SERVER_BOOT_TIME = 10.f;
+
+	// Extra time on top of the duration before the server is considered stuck
+	const float SERVER_TIMEOUT_MARGIN = 60.f;
+};
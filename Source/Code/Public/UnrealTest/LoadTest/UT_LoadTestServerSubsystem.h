@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_LoadTestServerSubsystem.generated.h"
+
+/**
+ * Server side of the load test, only created with -loadtest.
+ * Records frame times and bytes per connection, forces respawns through the game mode
+ * and appends a summary row to a CSV file before quitting after -loadtestduration seconds.
+ */
+UCLASS()
+class UNREALTEST_API UUT_LoadTestServerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+private:
+	// Bytes sent per second to each client connection
+	void SampleConnections();
+
+	// Destroys a random pawn and restarts its player through the game mode
+	void ForceRespawn();
+
+	void WriteReport() const;
+
+	// Game thread work time in ms of every frame since the test started, without the idle time up to the tick rate cap
+	TArray<float> FrameTimes;
+
+	// Average bytes per second per connection, one per second
+	TArray<float> BytesPerConnection;
+
+	int32 MaxConnections = 0;
+	int32 NumRespawns = 0;
+
+	float Duration = 120.f;
+	float ElapsedTime = 0.f;
+	float NextSampleTime = 0.f;
+	float NextRespawnTime = 0.f;
+	bool bReportWritten = false;
+
+	FString ReportPath;
+
+	// Clients need a moment to join before the churn starts
+	const float WARMUP_TIME = 10.f;
+	const float RESPAWN_INTERVAL = 2.f;
+};
@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Game thread counters of the RPCs handled by the module on authority, read by load tests.
+ */
+struct UNREALTEST_API FUT_NetCounters
+{
+	// Server RPCs received from clients
+	static int32 ServerRpcs;
+
+	// Multicast RPCs sent by the server
+	static int32 MulticastRpcs;
+
+	static void Reset();
+};
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UT_NetDormancySubsystem.generated.h"
+
+/**
+ * Dormancy lifecycle for rarely changing replicated actors.
+ * Actors start dormant, are woken on authority right before they change and go back
+ * to DORM_DormantAll once their awake time runs out. Pending changes are still sent before the channel goes dormant.
+ */
+UCLASS()
+class UNREALTEST_API UUT_NetDormancySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	// Wakes actor for at least AwakeSeconds, call on authority before changing replicated state
+	void WakeActor(AActor* Actor, float AwakeSeconds);
+
+	FORCEINLINE int32 GetNumAwakeActors() const { return AwakeActors.Num(); }
+
+private:
+	UPROPERTY()
+	TArray<AActor*> AwakeActors;
+
+	// World time the actor at the same index goes back to dormancy
+	TArray<float> DormantTimes;
+};
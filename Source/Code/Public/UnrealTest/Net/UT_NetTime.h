@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Server timestamps for replicated state, quantized to 16 bits.
+ * Resolution is a hundredth of a second and values wrap every ~655 seconds,
+ * so they are only meant for short lived animations.
+ */
+struct UNREALTEST_API FUT_NetTime
+{
+	// Server world time synced with clients
+	static float GetServerTime(const UWorld* World);
+
+	static uint16 Quantize(float ServerTime);
+
+	// Seconds from QuantizedTime to ServerTime, wrap aware
+	static float GetElapsed(uint16 QuantizedTime, float ServerTime);
+};
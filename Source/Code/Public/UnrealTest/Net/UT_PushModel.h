@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/UnrealNetwork.h"
+
+/**
+ * Push model replication for the properties of the module.
+ * Properties registered with these params are only compared after being marked dirty with MARK_PROPERTY_DIRTY_FROM_NAME.
+ * ut.PushModel=0 registers them as polled again, it is read when a class builds its replication layout
+ * so set it in config or on the command line. Engine side push model also needs net.IsPushModelEnabled=1.
+ */
+struct UNREALTEST_API FUT_PushModel
+{
+	static bool IsEnabled();
+
+	// Params for DOREPLIFETIME_WITH_PARAMS_FAST
+	static FDoRepLifetimeParams MakeParams(ELifetimeCondition Condition = COND_None);
+};
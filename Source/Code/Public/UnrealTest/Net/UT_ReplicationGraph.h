@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "UT_ReplicationGraph.generated.h"
+
+class UUT_ReplicationGraphNode_Teams;
+
+// How actors of a class are routed to the graph nodes
+UENUM()
+enum class EUT_ClassRepNodeMapping : uint8
+{
+	// Not routed, replicated by a connection node when needed
+	NotRouted,
+	// Replicated to every connection
+	RelevantAllConnections,
+	// Grid, never moves
+	Spatialize_Static,
+	// Grid, moves every frame
+	Spatialize_Dynamic,
+	// Grid, moves only while awake
+	Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph of the deathmatch game.
+ * Characters go to a spatial grid, doors to the dormancy aware part of the grid,
+ * game and player states are always relevant and teammates are always relevant to each other.
+ * Enabled through ReplicationDriverClassName of the net driver in DefaultEngine.ini.
+ */
+UCLASS(transient, config = Engine)
+class UNREALTEST_API UUT_ReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UUT_ReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// Characters of the team, rebuilt once per frame
+	const FActorRepListRefView* GetTeamCharacters(int32 TeamNum) const;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+	UUT_ReplicationGraphNode_Teams* TeamsNode;
+
+	// Size of a grid cell in uu
+	UPROPERTY(config)
+	float GridCellSize;
+
+	// Smallest expected world coordinate, the grid starts there
+	UPROPERTY(config)
+	float SpatialBiasX;
+
+	UPROPERTY(config)
+	float SpatialBiasY;
+
+	// Characters further away from a viewer are replicated to it at a lower rate
+	UPROPERTY(config)
+	float ReducedRateDistance;
+
+	// Replication period of characters far or out of view is multiplied by this
+	UPROPERTY(config)
+	int32 ReducedRatePeriodScale;
+
+	FORCEINLINE uint16 GetCharacterReplicationPeriodFrame() const { return CharacterReplicationPeriodFrame; }
+
+private:
+	EUT_ClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	void InitClassReplicationInfo(UClass* Class, bool bSpatialize);
+
+	TClassMap<EUT_ClassRepNodeMapping> ClassRepNodePolicies;
+
+	// Full rate replication period of characters
+	uint16 CharacterReplicationPeriodFrame;
+};
+
+/**
+ * Keeps characters grouped by team for the connection nodes, lists are rebuilt once per frame
+ * so team changes are picked up without notifications.
+ */
+UCLASS()
+class UNREALTEST_API UUT_ReplicationGraphNode_Teams : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	UUT_ReplicationGraphNode_Teams();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+	virtual void NotifyResetAllNetworkActors() override;
+	virtual void PrepareForReplication() override;
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override {}
+
+	const FActorRepListRefView* GetTeamCharacters(int32 TeamNum) const;
+
+	FORCEINLINE const FActorRepListRefView& GetCharacters() const { return Characters; }
+
+private:
+	FActorRepListRefView Characters;
+
+	TMap<int32, FActorRepListRefView> TeamCharacters;
+};
+
+/**
+ * Per connection node: the connection's own controller and view target plus every character of its team.
+ * Also lowers the replication rate of characters that are far from or behind every viewer of the connection.
+ */
+UCLASS()
+class UNREALTEST_API UUT_ReplicationGraphNode_TeamRelevancy_ForConnection : public UReplicationGraphNode_AlwaysRelevant_ForConnection
+{
+	GENERATED_BODY()
+
+public:
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+private:
+	void UpdateCharacterRates(const FConnectionGatherActorListParameters& Params) const;
+
+	// Cosine of the half angle in front of the viewer that counts as in view
+	const float VIEW_CONE_COS = 0.5f;
+	// Characters this close keep the full rate even behind the camera
+	const float FULL_RATE_RADIUS = 1000.f;
+};
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "UT_SessionSubsystem.generated.h"
+
+// Row of the session browser
+USTRUCT(BlueprintType)
+struct FUT_SessionInfo
+{
+	GENERATED_BODY()
+
+	// Index to pass to JoinSession
+	UPROPERTY(BlueprintReadOnly)
+	int32 ResultIndex = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly)
+	FString OwnerName;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 PingInMs = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumOpenConnections = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 MaxConnections = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSessionActionComplete, bool, bWasSuccessful);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSessionPageReady, int32, PageIndex, const TArray<FUT_SessionInfo>&, Sessions);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSessionSearchComplete, int32, NumSessions);
+
+/**
+ * Creates, finds and joins game sessions for the menus without blocking them.
+ * Search results are cached for CACHE_TTL and handed to the UI sorted by ping, one page per frame,
+ * so the list fills in instead of being rebuilt. A new search replaces the one in flight.
+ * Uses the default online subsystem, OnlineSubsystemNull with LAN sessions works on loopback.
+ */
+UCLASS()
+class UNREALTEST_API UUT_SessionSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// Hosts a session and travels to the map as a listen server, replaces the current session, stays on the current map when MapName is empty
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	void CreateSession(const FString& MapName, int32 MaxConnections, bool bIsLAN);
+
+	// Sends cached pages when the last search is fresh, searches again otherwise
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	void FindSessions(bool bIsLAN, bool bForceRefresh = false);
+
+	// Stops the search in flight and any pages still to be sent
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	void CancelFindSessions();
+
+	// Joins a result of the last search and travels to it
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	void JoinSession(int32 ResultIndex);
+
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	bool IsSearching() const;
+
+	// Cached results of the page, sorted by ping
+	UFUNCTION(BlueprintCallable, Category = "Sessions")
+	void GetSessionPage(int32 PageIndex, TArray<FUT_SessionInfo>& OutSessions) const;
+
+	UFUNCTION(BlueprintPure, Category = "Sessions")
+	int32 GetNumSessions() const { return SortedResults.Num(); }
+
+	UPROPERTY(BlueprintAssignable)
+	FOnSessionActionComplete OnCreateSessionComplete;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnSessionActionComplete OnJoinSessionComplete;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnSessionPageReady OnSessionPageReady;
+
+	// After the last page of a search, or of the cache, was sent
+	UPROPERTY(BlueprintAssignable)
+	FOnSessionSearchComplete OnSessionSearchComplete;
+
+	static constexpr int32 PAGE_SIZE = 10;
+
+private:
+	IOnlineSessionPtr GetSessionInterface() const;
+
+	// Destroys the current session first when there is one
+	void StartCreateSession();
+	void StartFindSessions();
+
+	// Cancels the search in flight without dropping the pending one
+	void CancelSearchInFlight();
+
+	void HandleCreateSessionComplete(FName SessionName, bool bWasSuccessful);
+	void HandleDestroySessionComplete(FName SessionName, bool bWasSuccessful);
+	void HandleFindSessionsComplete(bool bWasSuccessful);
+	void HandleCancelFindSessionsComplete(bool bWasSuccessful);
+	void HandleJoinSessionComplete(FName SessionName, EOnJoinSessionCompleteResult::Type Result);
+
+	// Sends the next page to the UI, stops once all pages are out
+	bool SendNextPage(float DeltaTime);
+	void StartSendingPages();
+	void StopSendingPages();
+
+	bool IsCacheFresh(bool bIsLAN) const;
+
+	FDelegateHandle CreateSessionHandle;
+	FDelegateHandle DestroySessionHandle;
+	FDelegateHandle FindSessionsHandle;
+	FDelegateHandle CancelFindSessionsHandle;
+	FDelegateHandle JoinSessionHandle;
+	FTSTicker::FDelegateHandle PageTickerHandle;
+
+	// Search in flight, replaced when a new search starts
+	TSharedPtr<FOnlineSessionSearch> ActiveSearch;
+
+	// Results of the last completed search and their order by ping
+	TArray<FOnlineSessionSearchResult> CachedResults;
+	TArray<int32> SortedResults;
+	bool bCachedLAN = false;
+	double CacheTime = -1.0;
+
+	// Settings of the request waiting for a destroy or a cancel to finish
+	FString PendingMapName;
+	int32 PendingMaxConnections = 0;
+	bool bPendingCreateLAN = false;
+	bool bPendingFindLAN = false;
+	bool bCreatePending = false;
+	bool bFindPending = false;
+	bool bCancelInFlight = false;
+
+	int32 NextPageIndex = 0;
+
+	// Seconds search results are served from the cache
+	static constexpr double CACHE_TTL = 30.0;
+	// Seconds a search waits for answers
+	static constexpr float SEARCH_TIMEOUT = 5.f;
+	static constexpr int32 MAX_SEARCH_RESULTS = 100;
+};
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+DECLARE_STATS_GROUP(TEXT("UnrealTest"), STATGROUP_UnrealTest, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Choose Player Start"), STAT_UT_ChoosePlayerStart, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Choose Team"), STAT_UT_ChooseTeam, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Team Change"), STAT_UT_TeamChange, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Team Colors"), STAT_UT_TeamColors, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interaction Query"), STAT_UT_Interaction, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Door Toggle"), STAT_UT_DoorToggle, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Door Animation"), STAT_UT_DoorAnimation, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ragdoll"), STAT_UT_Ragdoll, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Montage"), STAT_UT_Montage, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Lag Compensation"), STAT_UT_LagCompensation, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rewind Trace"), STAT_UT_RewindTrace, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Scoring"), STAT_UT_SpawnScoring, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"), STAT_UT_Significance, STATGROUP_UnrealTest, UNREALTEST_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Door Toggles"), STAT_UT_NumDoorToggles, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Spawns"), STAT_UT_NumSpawns, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Ragdoll RPCs"), STAT_UT_NumRagdollRpcs, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Moving Doors"), STAT_UT_NumMovingDoors, STATGROUP_UnrealTest, UNREALTEST_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Simulated Ragdolls"), STAT_UT_NumSimulatedRagdolls, STATGROUP_UnrealTest, UNREALTEST_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(UNREALTEST_API, UnrealTest);
+
+UE_TRACE_CHANNEL_EXTERN(UnrealTestChannel, UNREALTEST_API);
+
+UNREALTEST_API DECLARE_LOG_CATEGORY_EXTERN(LogUnrealTest, Log, All);
+
+// Stats kept over a whole match for ut.MatchPerfSummary, one per UT_SCOPE_STAT name
+enum class EUT_MatchStat : uint8
+{
+	ChoosePlayerStart,
+	ChooseTeam,
+	TeamChange,
+	TeamColors,
+	Interaction,
+	DoorToggle,
+	DoorAnimation,
+	Ragdoll,
+	Montage,
+	LagCompensation,
+	RewindTrace,
+	SpawnScoring,
+	Significance,
+	Num
+};
+
+/**
+ * Call count and time of every match stat since the match started, game thread only.
+ */
+struct UNREALTEST_API FUT_MatchStats
+{
+	static void Add(EUT_MatchStat Stat, uint64 Cycles);
+
+	static void Reset(float MatchStartTime);
+
+	// Writes a line per stat with calls, total, average and max time
+	static void Dump(FOutputDevice& Ar, float CurrentTime);
+
+private:
+	static uint32 Calls[static_cast<uint8>(EUT_MatchStat::Num)];
+	static uint64 TotalCycles[static_cast<uint8>(EUT_MatchStat::Num)];
+	static uint64 MaxCycles[static_cast<uint8>(EUT_MatchStat::Num)];
+	static float StartTime;
+};
+
+// Adds the scope time to the match stats
+struct FUT_ScopedMatchStat
+{
+	explicit FUT_ScopedMatchStat(EUT_MatchStat InStat)
+		: Stat(InStat)
+		, StartCycles(FPlatformTime::Cycles64())
+	{
+	}
+
+	~FUT_ScopedMatchStat()
+	{
+		FUT_MatchStats::Add(Stat, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+private:
+	EUT_MatchStat Stat;
+	uint64 StartCycles;
+};
+
+// Times the scope in the stat group, the CSV profiler, Insights and the match summary at once
+#define UT_SCOPE_STAT(Stat) \
+	SCOPE_CYCLE_COUNTER(STAT_UT_##Stat); \
+	CSV_SCOPED_TIMING_STAT(UnrealTest, Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(UT_##Stat, UnrealTestChannel); \
+	FUT_ScopedMatchStat PREPROCESSOR_JOIN(UTMatchStat_, __LINE__)(EUT_MatchStat::Stat)
@@ -10,7 +10,7 @@ public class UnrealTest : ModuleRules
 
 		PublicDependencyModuleNames.AddRange(new string[] 
 		{ 
-			"Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "OnlineSubsystem", "OnlineSubsystemUtils" 
+			"Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "OnlineSubsystem", "OnlineSubsystemUtils", "ReplicationGraph", "NetCore", "Json" 
 		});
 	}
 }
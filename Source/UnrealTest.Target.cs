@@ -10,5 +10,6 @@ public class UnrealTestTarget : TargetRules
 		Type = TargetType.Game;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.Add("UnrealTest");
+		bWithPushModel = true;
 	}
 }
@@ -10,5 +10,6 @@ public class UnrealTestEditorTarget : TargetRules
 		Type = TargetType.Editor;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		ExtraModuleNames.Add("UnrealTest");
+		bWithPushModel = true;
 	}
 }